@@ -0,0 +1,30 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/Binding.h"
+
+#include "Tentacle.h"
+
+namespace DI::Private
+{
+	/** Innermost lazy binding that the calling thread is constructing. */
+	static thread_local FLazyConstructionScope* GInnermostLazyConstructionScope = nullptr;
+
+	FLazyConstructionScope::FLazyConstructionScope(const FBinding& InBinding)
+		: Binding(InBinding), Outer(GInnermostLazyConstructionScope)
+	{
+		for (const FLazyConstructionScope* Scope = Outer; Scope; Scope = Scope->Outer)
+		{
+			if (&Scope->Binding == &Binding)
+			{
+				UE_LOG(LogDependencyInjection, Fatal, TEXT("The factory of lazy binding %s resolves its own binding."), *Binding.GetId().ToString());
+			}
+		}
+		GInnermostLazyConstructionScope = this;
+	}
+
+	FLazyConstructionScope::~FLazyConstructionScope()
+	{
+		GInnermostLazyConstructionScope = Outer;
+	}
+}
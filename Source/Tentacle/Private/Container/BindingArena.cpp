@@ -0,0 +1,96 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/BindingArena.h"
+
+namespace DI
+{
+	FBindingArena::~FBindingArena()
+	{
+		for (void* Page : Pages)
+		{
+			FMemory::Free(Page);
+		}
+	}
+
+	void* FBindingArena::Allocate(SIZE_T Size, FBindingArena* Arena)
+	{
+		static_assert(sizeof(FAllocationHeader) == Alignment);
+
+		const SIZE_T TotalSize = Size + sizeof(FAllocationHeader);
+		FAllocationHeader* Header;
+		if (Arena && TotalSize <= MaxPooledSize)
+		{
+			const uint32 SizeClass = static_cast<uint32>((TotalSize - 1) / SizeClassGranularity);
+			Header = static_cast<FAllocationHeader*>(Arena->AllocateBlock(SizeClass));
+			Header->Arena = Arena;
+			Header->SizeClass = SizeClass;
+			// Released again in Free. Keeps the pages alive for as long as any binding lives in them.
+			Arena->AddRef();
+		}
+		else
+		{
+			Header = static_cast<FAllocationHeader*>(FMemory::Malloc(TotalSize, Alignment));
+			Header->Arena = nullptr;
+			Header->SizeClass = 0;
+		}
+		return Header + 1;
+	}
+
+	void FBindingArena::Free(void* Memory)
+	{
+		if (!Memory)
+			return;
+
+		FAllocationHeader* Header = static_cast<FAllocationHeader*>(Memory) - 1;
+		if (FBindingArena* Arena = Header->Arena)
+		{
+			Arena->FreeBlock(Header, Header->SizeClass);
+			Arena->Release();
+		}
+		else
+		{
+			FMemory::Free(Header);
+		}
+	}
+
+	SIZE_T FBindingArena::GetReservedSize() const
+	{
+		FScopeLock ScopeLock(&Lock);
+		return ReservedSize;
+	}
+
+	void* FBindingArena::AllocateBlock(uint32 SizeClass)
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (FFreeBlock* Block = FreeLists[SizeClass])
+		{
+			FreeLists[SizeClass] = Block->Next;
+			return Block;
+		}
+
+		const SIZE_T BlockSize = (SizeClass + 1) * SizeClassGranularity;
+		if (PageCursor + BlockSize > PageEnd)
+		{
+			// The remainder of the old page is lost, which is at most one block of the biggest size class.
+			uint8* Page = static_cast<uint8*>(FMemory::Malloc(NextPageSize, Alignment));
+			Pages.Add(Page);
+			PageCursor = Page;
+			PageEnd = Page + NextPageSize;
+			ReservedSize += NextPageSize;
+			NextPageSize = FMath::Min(NextPageSize * 2, MaxPageSize);
+		}
+
+		void* Block = PageCursor;
+		PageCursor += BlockSize;
+		return Block;
+	}
+
+	void FBindingArena::FreeBlock(void* Block, uint32 SizeClass)
+	{
+		FScopeLock ScopeLock(&Lock);
+		FFreeBlock* FreeBlock = static_cast<FFreeBlock*>(Block);
+		FreeBlock->Next = FreeLists[SizeClass];
+		FreeLists[SizeClass] = FreeBlock;
+	}
+}
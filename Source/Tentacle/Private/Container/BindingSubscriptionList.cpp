@@ -5,33 +5,198 @@
 
 namespace DI
 {
-	void FBindingSubscriptionList::NotifyInstanceBound(const DI::FBinding& Binding)
+	FBindingSubscriptionList::FBindingSubscriptionList(const FBindingSubscriptionList&)
 	{
-		FOnInstanceBound Subscriptions;
-		if (!BindingToSubscriptions.RemoveAndCopyValue(Binding.GetId(), Subscriptions))
-			return;
+	}
 
-		Subscriptions.Broadcast(Binding);
+	FBindingSubscriptionList& FBindingSubscriptionList::operator=(const FBindingSubscriptionList&)
+	{
+		return *this;
 	}
 
-	auto FBindingSubscriptionList::SubscribeOnce(const FBindingId& BindingId) -> FOnInstanceBound&
+	FBindingSubscriptionList::~FBindingSubscriptionList()
 	{
-		return BindingToSubscriptions.FindOrAdd(BindingId);
+		// Pages destroy their waiters, which drops all callbacks that have never been invoked.
 	}
 
-	TArray<FBindingId> FBindingSubscriptionList::GetAllPendingBindingIds() const
+	FBindingSubscriptionHandle FBindingSubscriptionList::Subscribe(const FBindingKey& BindingKey, FOnInstanceBound&& Callback, const UObject* WaitingObject)
 	{
-		TArray<FBindingId> OutIds;
-		BindingToSubscriptions.GetKeys(OutIds);
-		return OutIds;
+		const int32 WaiterIndex = AllocateWaiter();
+		FWaiter& Waiter = GetWaiter(WaiterIndex);
+		Waiter.Callback = MoveTemp(Callback);
+		Waiter.WaitingObject = WaitingObject;
+		Waiter.bHasWaitingObject = WaitingObject != nullptr;
+		Waiter.Next = INDEX_NONE;
+		NumWaitersWithWaitingObject += Waiter.bHasWaitingObject ? 1 : 0;
+
+		FWaiterList& WaiterList = KeyToWaiters.FindOrAdd(BindingKey);
+		Waiter.Prev = WaiterList.Tail;
+		if (WaiterList.Tail != INDEX_NONE)
+		{
+			GetWaiter(WaiterList.Tail).Next = WaiterIndex;
+		}
+		else
+		{
+			WaiterList.Head = WaiterIndex;
+			WaiterList.ListId = ++LastListId;
+		}
+		Waiter.ListId = WaiterList.ListId;
+		WaiterList.Tail = WaiterIndex;
+		++WaiterList.NumSubscribed;
+
+		return {WaiterIndex, Waiter.Serial};
+	}
+
+	EUnsubscribeResult FBindingSubscriptionList::Unsubscribe(const FBindingKey& BindingKey, FBindingSubscriptionHandle Handle)
+	{
+		if (!Handle.IsValid() || Handle.WaiterIndex >= NumUsedWaiters)
+			return EUnsubscribeResult::NotSubscribed;
+
+		FWaiter& Waiter = GetWaiter(Handle.WaiterIndex);
+		if (Waiter.Serial != Handle.Serial || !Waiter.Callback)
+			return EUnsubscribeResult::NotSubscribed;
+
+		FWaiterList* WaiterList = KeyToWaiters.Find(BindingKey);
+		if (!WaiterList || WaiterList->ListId != Waiter.ListId)
+		{
+			// The waiter is in a list that is being notified right now, which frees it on its own.
+			Waiter.Callback.Reset();
+			return EUnsubscribeResult::Cancelled;
+		}
+
+		UnlinkWaiter(*WaiterList, Handle.WaiterIndex);
+		FreeWaiter(Handle.WaiterIndex);
+		if (WaiterList->NumSubscribed > 0)
+			return EUnsubscribeResult::Removed;
+
+		KeyToWaiters.Remove(BindingKey);
+		return EUnsubscribeResult::RemovedLastWaiter;
 	}
 
-	bool FBindingSubscriptionList::Unsubscribe(const FBindingId& BindingId, FDelegateHandle DelegateHandle)
+	bool FBindingSubscriptionList::NotifyInstanceBound(const DI::FBinding& Binding)
 	{
-		FOnInstanceBound* Subscriptions = BindingToSubscriptions.Find(BindingId);
-		if (!Subscriptions)
+		FWaiterList WaiterList;
+		if (!KeyToWaiters.RemoveAndCopyValue(Binding.GetId().GetKey(), WaiterList))
 			return false;
 
-		return Subscriptions->Remove(DelegateHandle);
+		// The list is detached, so callbacks can subscribe again without us seeing their waiters.
+		int32 WaiterIndex = WaiterList.Head;
+		while (WaiterIndex != INDEX_NONE)
+		{
+			FWaiter& Waiter = GetWaiter(WaiterIndex);
+			const int32 NextWaiterIndex = Waiter.Next;
+			FOnInstanceBound Callback = MoveTemp(Waiter.Callback);
+			const bool bIsWaitingObjectAlive = !Waiter.bHasWaitingObject || Waiter.WaitingObject.IsValid();
+			FreeWaiter(WaiterIndex);
+
+			if (Callback && bIsWaitingObjectAlive)
+			{
+				Callback(Binding);
+			}
+			WaiterIndex = NextWaiterIndex;
+		}
+		return true;
+	}
+
+	TArray<FBindingKey> FBindingSubscriptionList::RemoveAbandonedWaiters(TArray<FOnInstanceBound>& OutAbandonedCallbacks)
+	{
+		TArray<FBindingKey> RemovedKeys;
+		if (NumWaitersWithWaitingObject == 0)
+			return RemovedKeys;
+
+		for (auto It = KeyToWaiters.CreateIterator(); It; ++It)
+		{
+			FWaiterList& WaiterList = It.Value();
+			int32 WaiterIndex = WaiterList.Head;
+			while (WaiterIndex != INDEX_NONE)
+			{
+				FWaiter& Waiter = GetWaiter(WaiterIndex);
+				const int32 NextWaiterIndex = Waiter.Next;
+				if (Waiter.bHasWaitingObject && !Waiter.WaitingObject.IsValid())
+				{
+					OutAbandonedCallbacks.Add(MoveTemp(Waiter.Callback));
+					UnlinkWaiter(WaiterList, WaiterIndex);
+					FreeWaiter(WaiterIndex);
+				}
+				WaiterIndex = NextWaiterIndex;
+			}
+
+			if (WaiterList.NumSubscribed == 0)
+			{
+				RemovedKeys.Add(It.Key());
+				It.RemoveCurrent();
+			}
+		}
+		return RemovedKeys;
+	}
+
+	TArray<FBindingKey> FBindingSubscriptionList::GetAllPendingBindingKeys() const
+	{
+		TArray<FBindingKey> OutKeys;
+		KeyToWaiters.GetKeys(OutKeys);
+		return OutKeys;
+	}
+
+	int32 FBindingSubscriptionList::AllocateWaiter()
+	{
+		if (FirstFreeWaiter != INDEX_NONE)
+		{
+			const int32 WaiterIndex = FirstFreeWaiter;
+			FirstFreeWaiter = GetWaiter(WaiterIndex).Next;
+			return WaiterIndex;
+		}
+
+		if (NumUsedWaiters == Pages.Num() * WaitersPerPage)
+		{
+			Pages.Add(MakeUnique<FWaiter[]>(WaitersPerPage));
+		}
+		return NumUsedWaiters++;
+	}
+
+	void FBindingSubscriptionList::FreeWaiter(int32 WaiterIndex)
+	{
+		FWaiter& Waiter = GetWaiter(WaiterIndex);
+		Waiter.Callback.Reset();
+		Waiter.WaitingObject.Reset();
+		NumWaitersWithWaitingObject -= Waiter.bHasWaitingObject ? 1 : 0;
+		Waiter.bHasWaitingObject = false;
+		++Waiter.Serial;
+		Waiter.Next = FirstFreeWaiter;
+		FirstFreeWaiter = WaiterIndex;
+	}
+
+	void FBindingSubscriptionList::UnlinkWaiter(FWaiterList& WaiterList, int32 WaiterIndex)
+	{
+		FWaiter& Waiter = GetWaiter(WaiterIndex);
+		(Waiter.Prev != INDEX_NONE ? GetWaiter(Waiter.Prev).Next : WaiterList.Head) = Waiter.Next;
+		(Waiter.Next != INDEX_NONE ? GetWaiter(Waiter.Next).Prev : WaiterList.Tail) = Waiter.Prev;
+		Waiter.Prev = INDEX_NONE;
+		Waiter.Next = INDEX_NONE;
+		--WaiterList.NumSubscribed;
+	}
+
+	bool FPendingKeyIndex::Add(const FBindingKey& BindingKey)
+	{
+		return ++KeyToCount.FindOrAdd(BindingKey, 0) == 1;
+	}
+
+	bool FPendingKeyIndex::Remove(const FBindingKey& BindingKey)
+	{
+		int32* Count = KeyToCount.Find(BindingKey);
+		if (!ensureMsgf(Count, TEXT("FPendingKeyIndex::Remove: Key is not pending.")))
+			return false;
+
+		if (--*Count > 0)
+			return false;
+
+		KeyToCount.Remove(BindingKey);
+		return true;
+	}
+
+	TArray<FBindingKey> FPendingKeyIndex::GetKeys() const
+	{
+		TArray<FBindingKey> OutKeys;
+		KeyToCount.GetKeys(OutKeys);
+		return OutKeys;
 	}
 }
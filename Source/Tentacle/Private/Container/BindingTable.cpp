@@ -0,0 +1,337 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/BindingTable.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#define TENTACLE_BINDING_TABLE_SSE2 1
+#else
+#define TENTACLE_BINDING_TABLE_SSE2 0
+#endif
+
+namespace DI
+{
+	namespace BindingTable
+	{
+		constexpr int32 GroupWidth = 16;
+		constexpr int8 EmptyControl = -128;
+		constexpr int8 DeletedControl = -2;
+
+		FORCEINLINE int8 GetControlHash(uint32 Hash)
+		{
+			return static_cast<int8>(Hash & 0x7F);
+		}
+
+		FORCEINLINE uint32 GetGroupHash(uint32 Hash)
+		{
+			return Hash >> 7;
+		}
+
+		/** @return a bit mask with one bit per slot in the group whose control byte equals Control. */
+		FORCEINLINE uint32 MatchControl(const int8* Group, int8 Control)
+		{
+#if TENTACLE_BINDING_TABLE_SSE2
+			const __m128i Controls = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Group));
+			return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(Control), Controls)));
+#else
+			uint32 Mask = 0;
+			for (int32 Index = 0; Index < GroupWidth; ++Index)
+			{
+				Mask |= static_cast<uint32>(Group[Index] == Control) << Index;
+			}
+			return Mask;
+#endif
+		}
+
+		/** @return a bit mask with one bit per slot in the group that is either empty or deleted. */
+		FORCEINLINE uint32 MatchEmptyOrDeleted(const int8* Group)
+		{
+#if TENTACLE_BINDING_TABLE_SSE2
+			// Empty and deleted are the only control bytes with the sign bit set.
+			return static_cast<uint32>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Group))));
+#else
+			uint32 Mask = 0;
+			for (int32 Index = 0; Index < GroupWidth; ++Index)
+			{
+				Mask |= static_cast<uint32>(Group[Index] < 0) << Index;
+			}
+			return Mask;
+#endif
+		}
+
+		FORCEINLINE int32 GetGrowthLimit(int32 Capacity)
+		{
+			// Keep the maximum load factor at 7/8 so every probe sequence is guaranteed to end in an empty slot.
+			return Capacity - Capacity / 8;
+		}
+	}
+
+	TRefCountPtr<DI::FBinding>* FBindingTable::Find(const FBindingKey& Key)
+	{
+		return const_cast<TRefCountPtr<DI::FBinding>*>(static_cast<const FBindingTable*>(this)->Find(Key));
+	}
+
+	const TRefCountPtr<DI::FBinding>* FBindingTable::Find(const FBindingKey& Key) const
+	{
+#if TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+		if (UsesUnnamedSlot(Key))
+		{
+			const int32 TypeIndex = static_cast<int32>(Key.GetTypeIndex());
+			if (!UnnamedSlots.IsValidIndex(TypeIndex))
+				return nullptr;
+
+			const TRefCountPtr<DI::FBinding>& Binding = UnnamedSlots[TypeIndex].Binding;
+			return Binding.IsValid() ? &Binding : nullptr;
+		}
+#endif
+
+		const int32 SlotIndex = FindSlotIndex(Key);
+		return SlotIndex != INDEX_NONE ? &Slots[SlotIndex].Binding : nullptr;
+	}
+
+	void FBindingTable::Emplace(const FBindingKey& Key, TRefCountPtr<DI::FBinding> Binding)
+	{
+		bIsReferenceCacheDirty = true;
+
+#if TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+		if (UsesUnnamedSlot(Key))
+		{
+			const int32 TypeIndex = static_cast<int32>(Key.GetTypeIndex());
+			if (TypeIndex >= UnnamedSlots.Num())
+			{
+				UnnamedSlots.SetNum(TypeIndex + 1);
+			}
+
+			FSlot& Slot = UnnamedSlots[TypeIndex];
+			if (!Slot.Binding.IsValid())
+			{
+				++NumUnnamed;
+			}
+			Slot.Key = Key;
+			Slot.Binding = MoveTemp(Binding);
+			return;
+		}
+#endif
+
+		const int32 ExistingIndex = FindSlotIndex(Key);
+		if (ExistingIndex != INDEX_NONE)
+		{
+			Slots[ExistingIndex].Binding = MoveTemp(Binding);
+			return;
+		}
+
+		if (NumElements + NumDeleted >= BindingTable::GetGrowthLimit(Slots.Num()))
+		{
+			Rehash(NumElements + 1);
+		}
+
+		const int32 InsertIndex = FindInsertIndex(Key.GetHash());
+		if (Controls[InsertIndex] == BindingTable::DeletedControl)
+		{
+			--NumDeleted;
+		}
+		Controls[InsertIndex] = BindingTable::GetControlHash(Key.GetHash());
+		Slots[InsertIndex].Key = Key;
+		Slots[InsertIndex].Binding = MoveTemp(Binding);
+		++NumElements;
+	}
+
+	bool FBindingTable::Remove(const FBindingKey& Key)
+	{
+		bIsReferenceCacheDirty = true;
+
+#if TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+		if (UsesUnnamedSlot(Key))
+		{
+			const int32 TypeIndex = static_cast<int32>(Key.GetTypeIndex());
+			if (!UnnamedSlots.IsValidIndex(TypeIndex) || !UnnamedSlots[TypeIndex].Binding.IsValid())
+				return false;
+
+			UnnamedSlots[TypeIndex] = FSlot();
+			--NumUnnamed;
+			return true;
+		}
+#endif
+
+		const int32 SlotIndex = FindSlotIndex(Key);
+		if (SlotIndex == INDEX_NONE)
+			return false;
+
+		// Probes only ever continue past groups without empty slots.
+		// If this group still has an empty slot, no probe sequence depends on this slot and it can become empty again.
+		const int8* Group = Controls.GetData() + (SlotIndex / BindingTable::GroupWidth) * BindingTable::GroupWidth;
+		if (BindingTable::MatchControl(Group, BindingTable::EmptyControl) != 0)
+		{
+			Controls[SlotIndex] = BindingTable::EmptyControl;
+		}
+		else
+		{
+			Controls[SlotIndex] = BindingTable::DeletedControl;
+			++NumDeleted;
+		}
+		Slots[SlotIndex] = FSlot();
+		--NumElements;
+		return true;
+	}
+
+	void FBindingTable::Reserve(int32 NumBindings)
+	{
+		if (NumBindings > BindingTable::GetGrowthLimit(Slots.Num()) - NumDeleted)
+		{
+			Rehash(NumBindings);
+		}
+	}
+
+	void FBindingTable::Empty()
+	{
+		Controls.Empty();
+		Slots.Empty();
+		NumElements = 0;
+		NumDeleted = 0;
+#if TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+		UnnamedSlots.Empty();
+#endif
+		NumUnnamed = 0;
+		ObjectReferenceSlots.Empty();
+		BindingsWithComplexReferences.Empty();
+		bIsReferenceCacheDirty = false;
+	}
+
+	void FBindingTable::Reset()
+	{
+		if (NumElements > 0 || NumDeleted > 0)
+		{
+			for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+			{
+				if (Controls[SlotIndex] >= 0)
+				{
+					Slots[SlotIndex] = FSlot();
+				}
+			}
+			FMemory::Memset(Controls.GetData(), BindingTable::EmptyControl, Controls.Num());
+		}
+		NumElements = 0;
+		NumDeleted = 0;
+#if TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+		UnnamedSlots.Reset();
+#endif
+		NumUnnamed = 0;
+		ObjectReferenceSlots.Reset();
+		BindingsWithComplexReferences.Reset();
+		bIsReferenceCacheDirty = false;
+	}
+
+	void FBindingTable::AddReferencedObjects(FReferenceCollector& Collector)
+	{
+		if (bIsReferenceCacheDirty)
+		{
+			RebuildReferenceCache();
+		}
+
+		for (TObjectPtr<UObject>* ObjectReferenceSlot : ObjectReferenceSlots)
+		{
+			Collector.AddStableReference(ObjectReferenceSlot);
+		}
+		for (DI::FBinding* Binding : BindingsWithComplexReferences)
+		{
+			Binding->AddReferencedObjects(Collector);
+		}
+	}
+
+	void FBindingTable::RebuildReferenceCache()
+	{
+		ObjectReferenceSlots.Reset();
+		BindingsWithComplexReferences.Reset();
+		for (const FSlot& Slot : *this)
+		{
+			if (Slot.Binding->HasComplexReferences())
+			{
+				BindingsWithComplexReferences.Add(Slot.Binding.GetReference());
+			}
+			else if (TObjectPtr<UObject>* ObjectReferenceSlot = Slot.Binding->GetObjectReferenceSlot())
+			{
+				ObjectReferenceSlots.Add(ObjectReferenceSlot);
+			}
+		}
+		bIsReferenceCacheDirty = false;
+	}
+
+	int32 FBindingTable::FindSlotIndex(const FBindingKey& Key) const
+	{
+		if (NumElements == 0)
+			return INDEX_NONE;
+
+		const uint32 Hash = Key.GetHash();
+		const int8 ControlHash = BindingTable::GetControlHash(Hash);
+		const uint32 GroupMask = static_cast<uint32>(Slots.Num() / BindingTable::GroupWidth) - 1;
+		uint32 GroupIndex = BindingTable::GetGroupHash(Hash) & GroupMask;
+
+		// Triangular probing visits every group exactly once because the number of groups is a power of two.
+		for (uint32 ProbeIndex = 1; ProbeIndex <= GroupMask + 1; ++ProbeIndex)
+		{
+			const int32 GroupStart = static_cast<int32>(GroupIndex) * BindingTable::GroupWidth;
+			const int8* Group = Controls.GetData() + GroupStart;
+			for (uint32 Match = BindingTable::MatchControl(Group, ControlHash); Match != 0; Match &= Match - 1)
+			{
+				const int32 SlotIndex = GroupStart + static_cast<int32>(FMath::CountTrailingZeros(Match));
+				if (Slots[SlotIndex].Key == Key)
+				{
+					return SlotIndex;
+				}
+			}
+
+			if (BindingTable::MatchControl(Group, BindingTable::EmptyControl) != 0)
+				return INDEX_NONE;
+
+			GroupIndex = (GroupIndex + ProbeIndex) & GroupMask;
+		}
+		return INDEX_NONE;
+	}
+
+	int32 FBindingTable::FindInsertIndex(uint32 Hash) const
+	{
+		const uint32 GroupMask = static_cast<uint32>(Slots.Num() / BindingTable::GroupWidth) - 1;
+		uint32 GroupIndex = BindingTable::GetGroupHash(Hash) & GroupMask;
+		for (uint32 ProbeIndex = 1;; ++ProbeIndex)
+		{
+			const int32 GroupStart = static_cast<int32>(GroupIndex) * BindingTable::GroupWidth;
+			if (const uint32 Match = BindingTable::MatchEmptyOrDeleted(Controls.GetData() + GroupStart))
+			{
+				return GroupStart + static_cast<int32>(FMath::CountTrailingZeros(Match));
+			}
+
+			// The load factor guarantees that there is a free slot somewhere.
+			checkSlow(ProbeIndex <= GroupMask);
+			GroupIndex = (GroupIndex + ProbeIndex) & GroupMask;
+		}
+	}
+
+	void FBindingTable::Rehash(int32 MinNumBindings)
+	{
+		int32 NewCapacity = BindingTable::GroupWidth;
+		while (BindingTable::GetGrowthLimit(NewCapacity) < MinNumBindings)
+		{
+			NewCapacity *= 2;
+		}
+
+		TArray<int8> OldControls = MoveTemp(Controls);
+		TArray<FSlot> OldSlots = MoveTemp(Slots);
+
+		Controls.Init(BindingTable::EmptyControl, NewCapacity);
+		Slots.SetNum(NewCapacity);
+		NumDeleted = 0;
+
+		for (int32 OldIndex = 0; OldIndex < OldSlots.Num(); ++OldIndex)
+		{
+			if (OldControls[OldIndex] < 0)
+				continue;
+
+			FSlot& OldSlot = OldSlots[OldIndex];
+			const uint32 Hash = OldSlot.Key.GetHash();
+			const int32 NewIndex = FindInsertIndex(Hash);
+			Controls[NewIndex] = BindingTable::GetControlHash(Hash);
+			Slots[NewIndex] = MoveTemp(OldSlot);
+		}
+	}
+}
@@ -4,13 +4,45 @@
 #include "Container/ChainedDiContainer.h"
 #include "Tentacle.h"
 
+DI::FChainedDiContainer::FChainedDiContainer()
+{
+	LookupTables.Add(GetOwnLookupTable());
+}
+
+DI::FChainedDiContainer::~FChainedDiContainer()
+{
+	// Nobody in our subtree is going to wait for anything anymore.
+	if (!SubtreePendingKeys.IsEmpty())
+	{
+		if (TSharedPtr<FConnectedDiContainer> PinnedParent = ParentContainer.Pin())
+		{
+			PinnedParent->RemoveSubtreePendingKeys(SubtreePendingKeys.GetKeys());
+		}
+	}
+
+	// Our children may have cached our bindings and still point to our tables.
+	if (ChildrenContainers.Num() > 0)
+	{
+		// Our weak pointer has already expired, so our children will drop us from their caches.
+		for (const TWeakPtr<FConnectedDiContainer>& WeakChildContainer : ChildrenContainers)
+		{
+			if (TSharedPtr<FConnectedDiContainer> ChildContainer = WeakChildContainer.Pin())
+			{
+				ChildContainer->RebuildAncestorCaches();
+			}
+		}
+	}
+}
+
 void DI::FChainedDiContainer::SetParentContainer(TSharedPtr<FConnectedDiContainer> DiContainer)
 {
 	if (ParentContainer == DiContainer)
 		return;
 
+	const TArray<FBindingKey> PendingKeys = SubtreePendingKeys.GetKeys();
 	if (TSharedPtr<FConnectedDiContainer> PinnedParent = ParentContainer.Pin())
 	{
+		PinnedParent->RemoveSubtreePendingKeys(PendingKeys);
 		if (!PinnedParent->TryDisconnectSubcontainer(AsShared()))
 		{
 			UE_LOG(LogDependencyInjection, Warning, TEXT("FChainedDiContainer::SetParentContainer: Failed to disconnect from parent container."));
@@ -18,8 +50,14 @@ void DI::FChainedDiContainer::SetParentContainer(TSharedPtr<FConnectedDiContaine
 	}
 
 	ParentContainer = DiContainer;
+	RebuildAncestorCaches();
+
+	if (!DiContainer)
+		return;
 
-	if (DiContainer && !DiContainer->TryConnectSubcontainer(AsShared()))
+	// Has to happen before connecting, which resolves pending waits and removes their keys again.
+	DiContainer->AddSubtreePendingKeys(PendingKeys);
+	if (!DiContainer->TryConnectSubcontainer(AsShared()))
 	{
 		UE_LOG(LogDependencyInjection, Error, TEXT("FChainedDiContainer::SetParentContainer: Failed to connect to new parent container."));
 	}
@@ -27,16 +65,29 @@ void DI::FChainedDiContainer::SetParentContainer(TSharedPtr<FConnectedDiContaine
 
 void DI::FChainedDiContainer::AddReferencedObjects(FReferenceCollector& Collector)
 {
-	for (auto& [BindingId, Binding] : Bindings)
-	{
-		Binding->AddReferencedObjects(Collector);
-	}
+	Bindings.AddReferencedObjects(Collector);
+}
+
+void DI::FChainedDiContainer::Freeze(EFrozenBindBehavior BindBehavior)
+{
+	FrozenBindings = FFrozenBindingTable(Bindings);
+	FrozenBindBehavior = BindBehavior;
+	bIsFrozen = true;
+	// Switch ourselves and our descendants over to the frozen table.
+	RebuildAncestorCaches();
+}
+
+void DI::FChainedDiContainer::Thaw()
+{
+	bIsFrozen = false;
+	RebuildAncestorCaches();
+	FrozenBindings = FFrozenBindingTable();
 }
 
 bool DI::FChainedDiContainer::TryConnectSubcontainer(TSharedRef<FConnectedDiContainer> ConnectedDiContainer)
 {
 	ChildrenContainers.AddUnique(ConnectedDiContainer);
-	ConnectedDiContainer->RetryAllPendingWaits();
+	ConnectedDiContainer->RetryPendingWaits(GetLookupTables());
 	return true;
 }
 
@@ -45,9 +96,34 @@ bool DI::FChainedDiContainer::TryDisconnectSubcontainer(TSharedRef<FConnectedDiC
 	return ChildrenContainers.Remove(ConnectedDiContainer) > 0;
 }
 
-void DI::FChainedDiContainer::NotifyInstanceBound(const DI::FBinding& NewBinding) const
+void DI::FChainedDiContainer::NotifyInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) const
 {
-	Subscriptions.NotifyInstanceBound(NewBinding);
+	// Bindings that somebody in our children's subtrees waits for. Everything else stops here.
+	TArray<const DI::FBinding*, TInlineAllocator<32>> ChildBindings;
+	TArray<const DI::FBinding*, TInlineAllocator<8>> OwnBindings;
+	for (const DI::FBinding* NewBinding : NewBindings)
+	{
+		const FBindingKey& BindingKey = NewBinding->GetId().GetKey();
+		const bool bIsOwnPending = Subscriptions.IsPending(BindingKey);
+		// A nearer binding may shadow the new one, e.g. one of ours whose deferred notification is still queued.
+		// Our subscribers get that one once it is delivered.
+		if (bIsOwnPending && FindBindingRaw(BindingKey) == NewBinding)
+		{
+			OwnBindings.Add(NewBinding);
+		}
+		if (SubtreePendingKeys.GetCount(BindingKey) > (bIsOwnPending ? 1 : 0))
+		{
+			ChildBindings.Add(NewBinding);
+		}
+	}
+
+	if (OwnBindings.Num() > 0)
+	{
+		NotifySubscribers(OwnBindings);
+	}
+	if (ChildBindings.Num() == 0)
+		return;
+
 	for (auto ChildrenContainerIt = ChildrenContainers.CreateIterator(); ChildrenContainerIt; ++ChildrenContainerIt)
 	{
 		TSharedPtr<FConnectedDiContainer> ChainedDiContainer = ChildrenContainerIt->Pin();
@@ -57,20 +133,42 @@ void DI::FChainedDiContainer::NotifyInstanceBound(const DI::FBinding& NewBinding
 			continue;
 		}
 
-		ChainedDiContainer->NotifyInstanceBound(NewBinding);
+		ChainedDiContainer->NotifyInstancesBound(ChildBindings);
 	}
 }
 
-void DI::FChainedDiContainer::RetryAllPendingWaits() const
+void DI::FChainedDiContainer::NotifySubscribers(TConstArrayView<const DI::FBinding*> NewBindings) const
 {
-	TArray<FBindingId> BindingIds = Subscriptions.GetAllPendingBindingIds();
-	for (const FBindingId& BindingId : BindingIds)
+	TArray<FBindingKey, TInlineAllocator<8>> NotifiedKeys;
+	for (const DI::FBinding* NewBinding : NewBindings)
 	{
-		if (TSharedPtr<DI::FBinding> Binding = FindBinding(BindingId))
+		if (Subscriptions.NotifyInstanceBound(*NewBinding))
 		{
-			Subscriptions.NotifyInstanceBound(*Binding);
+			NotifiedKeys.Add(NewBinding->GetId().GetKey());
 		}
 	}
+	if (NotifiedKeys.Num() > 0)
+	{
+		// Subscribers that subscribed to the same key again while being notified have added it once more, so the count stays balanced.
+		RemoveSubtreePendingKeys(NotifiedKeys);
+	}
+}
+
+TConstArrayView<DI::FLookupTable> DI::FChainedDiContainer::GetLookupTables() const
+{
+	return LookupTables;
+}
+
+void DI::FChainedDiContainer::RebuildAncestorCaches() const
+{
+	LookupTables.Reset();
+	LookupTables.Add(GetOwnLookupTable());
+	if (TSharedPtr<FConnectedDiContainer> ParentDiContainer = ParentContainer.Pin())
+	{
+		LookupTables.Append(ParentDiContainer->GetLookupTables());
+	}
+	// Our ancestors may have changed, so discard the resolve cache and recombine the ancestor filter on the next lookup.
+	AncestorCacheGeneration = InvalidCacheGeneration;
 
 	for (auto ChildrenContainerIt = ChildrenContainers.CreateIterator(); ChildrenContainerIt; ++ChildrenContainerIt)
 	{
@@ -81,58 +179,320 @@ void DI::FChainedDiContainer::RetryAllPendingWaits() const
 			continue;
 		}
 
-		ChildContainer->RetryAllPendingWaits();
+		ChildContainer->RebuildAncestorCaches();
+	}
+}
+
+void DI::FChainedDiContainer::AddSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const
+{
+	TArray<FBindingKey, TInlineAllocator<8>> NewPendingKeys;
+	for (const FBindingKey& BindingKey : BindingKeys)
+	{
+		if (SubtreePendingKeys.Add(BindingKey))
+		{
+			NewPendingKeys.Add(BindingKey);
+		}
+	}
+
+	if (NewPendingKeys.Num() > 0)
+	{
+		if (TSharedPtr<FConnectedDiContainer> ParentDiContainer = ParentContainer.Pin())
+		{
+			ParentDiContainer->AddSubtreePendingKeys(NewPendingKeys);
+		}
 	}
 }
 
-TSharedPtr<DI::FBinding> DI::FChainedDiContainer::FindConnectedBinding(const DI::FBindingId& BindingId) const
+const DI::FPendingKeyIndex& DI::FChainedDiContainer::GetSubtreePendingKeys() const
 {
-	return FindBinding(BindingId);
+	return SubtreePendingKeys;
 }
 
-DI::EBindResult DI::FChainedDiContainer::BindSpecific(TSharedRef<FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior)
+void DI::FChainedDiContainer::RemoveSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const
 {
+	TArray<FBindingKey, TInlineAllocator<8>> RemovedPendingKeys;
+	for (const FBindingKey& BindingKey : BindingKeys)
+	{
+		if (SubtreePendingKeys.Remove(BindingKey))
+		{
+			RemovedPendingKeys.Add(BindingKey);
+		}
+	}
+
+	if (RemovedPendingKeys.Num() > 0)
+	{
+		if (TSharedPtr<FConnectedDiContainer> ParentDiContainer = ParentContainer.Pin())
+		{
+			ParentDiContainer->RemoveSubtreePendingKeys(RemovedPendingKeys);
+		}
+	}
+}
+
+DI::EBindResult DI::FChainedDiContainer::BindSpecific(TRefCountPtr<FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior)
+{
+	if (RejectBindIfFrozen(SpecificBinding->GetId()))
+		return EBindResult::Frozen;
+
+	const DI::FBinding* NewBinding = TryAddBinding(SpecificBinding, ConflictBehavior);
+	if (!NewBinding)
+		return EBindResult::Conflict;
+
+	OnBindingsAdded();
+	DispatchInstancesBound(MakeArrayView(&NewBinding, 1));
+	return EBindResult::Bound;
+}
+
+DI::EBindResult DI::FChainedDiContainer::BindSpecificMany(TConstArrayView<TRefCountPtr<DI::FBinding>> SpecificBindings, EBindConflictBehavior ConflictBehavior)
+{
+	if (SpecificBindings.Num() == 0)
+		return EBindResult::Bound;
+
+	if (RejectBindIfFrozen(SpecificBindings[0]->GetId()))
+		return EBindResult::Frozen;
+
 	EBindResult OverallResult = EBindResult::Bound;
-	FBindingId BindingId = SpecificBinding->GetId();
-	if (TSharedRef<FBinding>* Binding = Bindings.Find(BindingId))
+	TArray<const DI::FBinding*, TInlineAllocator<32>> NewBindings;
+	Bindings.Reserve(Bindings.Num() + SpecificBindings.Num());
+	for (const TRefCountPtr<DI::FBinding>& SpecificBinding : SpecificBindings)
 	{
-		if ((*Binding)->IsValid())
+		const DI::FBinding* NewBinding = TryAddBinding(SpecificBinding, ConflictBehavior);
+		if (!NewBinding)
 		{
-			HandleBindingConflict(BindingId, ConflictBehavior);
-			return EBindResult::Conflict;
+			OverallResult = EBindResult::Conflict;
+			continue;
 		}
+		NewBindings.Add(NewBinding);
+	}
+
+	if (NewBindings.Num() > 0)
+	{
+		OnBindingsAdded();
+		// Notify only after all bindings are in, so subscribers can already resolve the rest of the batch.
+		DispatchInstancesBound(NewBindings);
 	}
-	Bindings.Emplace(BindingId, SpecificBinding);
-	NotifyInstanceBound(*SpecificBinding);
 	return OverallResult;
 }
 
-TSharedPtr<DI::FBinding> DI::FChainedDiContainer::FindBinding(const FBindingId& BindingId) const
+void DI::FChainedDiContainer::DeliverInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings)
+{
+	NotifyInstancesBound(NewBindings);
+}
+
+bool DI::FChainedDiContainer::RejectBindIfFrozen(const FBindingId& BindingId) const
+{
+	if (!bIsFrozen || FrozenBindBehavior != EFrozenBindBehavior::Reject)
+		return false;
+
+	UE_LOG(LogDependencyInjection, Error, TEXT("FChainedDiContainer::BindSpecific: Can not bind %s because the container is frozen."), *BindingId.ToString());
+	return true;
+}
+
+DI::FBinding* DI::FChainedDiContainer::TryAddBinding(const TRefCountPtr<DI::FBinding>& SpecificBinding, EBindConflictBehavior ConflictBehavior)
+{
+	DI::FBinding* NewBinding = TryAddBindingToTable(Bindings, SpecificBinding, ConflictBehavior);
+	if (NewBinding)
+	{
+		BindingFilter.Add(SpecificBinding->GetId().GetKey());
+	}
+	return NewBinding;
+}
+
+void DI::FChainedDiContainer::RemoveInvalidBindings()
+{
+	if (RemoveInvalidBindingsFromTable(Bindings) == 0)
+		return;
+
+	if (bIsFrozen)
+	{
+		FrozenBindings = FFrozenBindingTable(Bindings);
+	}
+	// Our descendants may have cached the removed bindings.
+	++BindingGeneration;
+}
+
+void DI::FChainedDiContainer::RemoveAbandonedWaiters(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks)
+{
+	const TArray<FBindingKey> RemovedKeys = Subscriptions.RemoveAbandonedWaiters(OutAbandonedCallbacks);
+	if (RemovedKeys.Num() > 0)
+	{
+		RemoveSubtreePendingKeys(RemovedKeys);
+	}
+}
+
+void DI::FChainedDiContainer::OnBindingsAdded()
+{
+	if (bIsFrozen)
+	{
+		FrozenBindings = FFrozenBindingTable(Bindings);
+	}
+	// The new bindings may shadow bindings that our descendants have cached from our ancestors.
+	++BindingGeneration;
+}
+
+DI::FLookupTable DI::FChainedDiContainer::GetOwnLookupTable() const
+{
+	return {&Bindings, bIsFrozen ? &FrozenBindings : nullptr, &BindingFilter, &BindingGeneration};
+}
+
+void DI::FChainedDiContainer::RefreshAncestorCaches() const
+{
+	// Generations only ever grow, so their sum changes whenever any ancestor binds or removes bindings.
+	// Changes to the ancestors themselves invalidate the cache in RebuildAncestorCaches.
+	uint64 AncestorGeneration = 0;
+	// The first table is our own.
+	for (int32 TableIndex = 1; TableIndex < LookupTables.Num(); ++TableIndex)
+	{
+		AncestorGeneration += *LookupTables[TableIndex].Generation;
+	}
+	if (AncestorCacheGeneration == AncestorGeneration)
+		return;
+
+	ResolveCache.Reset();
+	AncestorBindingFilter.Reset();
+	for (int32 TableIndex = 1; TableIndex < LookupTables.Num(); ++TableIndex)
+	{
+		AncestorBindingFilter.Append(*LookupTables[TableIndex].Filter);
+	}
+	AncestorCacheGeneration = AncestorGeneration;
+}
+
+TRefCountPtr<DI::FBinding> DI::FChainedDiContainer::FindBinding(const FBindingId& BindingId) const
 {
-	if (const TSharedRef<FBinding>* DependencyBinding = Bindings.Find(BindingId))
+	return FindBinding(BindingId.GetKey());
+}
+
+TRefCountPtr<DI::FBinding> DI::FChainedDiContainer::FindBinding(const FBindingKey& BindingKey) const
+{
+	return TRefCountPtr<FBinding>(const_cast<FBinding*>(FindBindingRaw(BindingKey)));
+}
+
+const DI::FBinding* DI::FChainedDiContainer::FindBindingRaw(const FBindingKey& BindingKey) const
+{
+	// Invalid bindings are removed after garbage collection, so everything in our tables can be trusted.
+	const TRefCountPtr<FBinding>* DependencyBinding = bIsFrozen ? FrozenBindings.Find(BindingKey) : Bindings.Find(BindingKey);
+	if (DependencyBinding)
 	{
-		if ((*DependencyBinding)->IsValid())
+		return DependencyBinding->GetReference();
+	}
+
+	RefreshAncestorCaches();
+
+	// Definitely not bound in any ancestor, so there is no need to walk the chain.
+	if (!AncestorBindingFilter.MightContain(BindingKey))
+		return nullptr;
+
+	if (const TRefCountPtr<FBinding>* CachedBinding = ResolveCache.Find(BindingKey))
+	{
+		// Removing invalid bindings from an ancestor bumps its generation, so cached bindings are always valid.
+		return CachedBinding->GetReference();
+	}
+
+	// The first table is our own, which we have already checked.
+	for (int32 TableIndex = 1; TableIndex < LookupTables.Num(); ++TableIndex)
+	{
+		if (const TRefCountPtr<FBinding>* AncestorBinding = LookupTables[TableIndex].Find(BindingKey))
 		{
-			return *DependencyBinding;
+			ResolveCache.Add(BindingKey, *AncestorBinding);
+			return AncestorBinding->GetReference();
 		}
 	}
+	return nullptr;
+}
 
-	if (TSharedPtr<FConnectedDiContainer> ParentDiContainer = ParentContainer.Pin())
+void DI::FChainedDiContainer::FindBindings(TConstArrayView<FBindingId> BindingIds, TArrayView<const DI::FBinding*> OutBindings) const
+{
+	check(BindingIds.Num() == OutBindings.Num());
+
+	// Indices of the bindings that are neither bound here nor cached and might be bound in an ancestor.
+	TArray<int32, TInlineAllocator<16>> UnresolvedIndices;
+	bool bHasRefreshedAncestorCaches = false;
+	for (int32 BindingIndex = 0; BindingIndex < BindingIds.Num(); ++BindingIndex)
 	{
-		return ParentDiContainer->FindConnectedBinding(BindingId);
+		const FBindingKey& BindingKey = BindingIds[BindingIndex].GetKey();
+		const TRefCountPtr<FBinding>* DependencyBinding = bIsFrozen ? FrozenBindings.Find(BindingKey) : Bindings.Find(BindingKey);
+		OutBindings[BindingIndex] = DependencyBinding ? DependencyBinding->GetReference() : nullptr;
+		if (DependencyBinding)
+			continue;
+
+		if (!bHasRefreshedAncestorCaches)
+		{
+			RefreshAncestorCaches();
+			bHasRefreshedAncestorCaches = true;
+		}
+		if (!AncestorBindingFilter.MightContain(BindingKey))
+			continue;
+
+		if (const TRefCountPtr<FBinding>* CachedBinding = ResolveCache.Find(BindingKey))
+		{
+			OutBindings[BindingIndex] = CachedBinding->GetReference();
+			continue;
+		}
+		UnresolvedIndices.Add(BindingIndex);
+	}
+
+	// The first table is our own, which we have already checked.
+	for (int32 TableIndex = 1; TableIndex < LookupTables.Num() && UnresolvedIndices.Num() > 0; ++TableIndex)
+	{
+		const FLookupTable& LookupTable = LookupTables[TableIndex];
+		for (int32 UnresolvedIndex = UnresolvedIndices.Num() - 1; UnresolvedIndex >= 0; --UnresolvedIndex)
+		{
+			const int32 BindingIndex = UnresolvedIndices[UnresolvedIndex];
+			const FBindingKey& BindingKey = BindingIds[BindingIndex].GetKey();
+			if (const TRefCountPtr<FBinding>* AncestorBinding = LookupTable.Find(BindingKey))
+			{
+				ResolveCache.Add(BindingKey, *AncestorBinding);
+				OutBindings[BindingIndex] = AncestorBinding->GetReference();
+				UnresolvedIndices.RemoveAtSwap(UnresolvedIndex, 1, EAllowShrinking::No);
+			}
+		}
 	}
-	return {};
 }
 
-DI::FBindingSubscriptionList::FOnInstanceBound& DI::FChainedDiContainer::Subscribe(
-	const FBindingId& BindingId) const
+void DI::FChainedDiContainer::ForEachBinding(const FBindingKey& BindingKey, TFunctionRef<void(const DI::FBinding&)> Visitor) const
 {
-	return Subscriptions.SubscribeOnce(BindingId);
+	const TRefCountPtr<FBinding>* DependencyBinding = bIsFrozen ? FrozenBindings.Find(BindingKey) : Bindings.Find(BindingKey);
+	if (DependencyBinding)
+	{
+		Visitor(**DependencyBinding);
+	}
+
+	RefreshAncestorCaches();
+	if (!AncestorBindingFilter.MightContain(BindingKey))
+		return;
+
+	for (int32 TableIndex = 1; TableIndex < LookupTables.Num(); ++TableIndex)
+	{
+		if (const TRefCountPtr<FBinding>* AncestorBinding = LookupTables[TableIndex].Find(BindingKey))
+		{
+			Visitor(**AncestorBinding);
+		}
+	}
+}
+
+DI::FBindingSubscriptionHandle DI::FChainedDiContainer::Subscribe(const FBindingId& BindingId, FBindingSubscriptionList::FOnInstanceBound&& Callback, const UObject* WaitingObject) const
+{
+	const FBindingKey& BindingKey = BindingId.GetKey();
+	if (!Subscriptions.IsPending(BindingKey))
+	{
+		AddSubtreePendingKeys(MakeArrayView(&BindingKey, 1));
+	}
+	if (WaitingObject)
+	{
+		EnsureSweptAfterGarbageCollection();
+	}
+	return Subscriptions.Subscribe(BindingKey, MoveTemp(Callback), WaitingObject);
 }
 
-bool DI::FChainedDiContainer::Unsubscribe(const FBindingId& BindingId, FDelegateHandle DelegateHandle) const
+bool DI::FChainedDiContainer::Unsubscribe(const FBindingId& BindingId, FBindingSubscriptionHandle Handle) const
 {
-	return Subscriptions.Unsubscribe(BindingId, DelegateHandle);
+	const FBindingKey& BindingKey = BindingId.GetKey();
+	const EUnsubscribeResult Result = Subscriptions.Unsubscribe(BindingKey, Handle);
+	// Keys that are being notified are removed from the pending keys by the notification itself.
+	if (Result == EUnsubscribeResult::RemovedLastWaiter)
+	{
+		RemoveSubtreePendingKeys(MakeArrayView(&BindingKey, 1));
+	}
+	return Result != EUnsubscribeResult::NotSubscribed;
 }
 
 void FChainedDiContainerGCd::AddStructReferencedObjects(FReferenceCollector& Collector)
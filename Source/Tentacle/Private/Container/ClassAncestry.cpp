@@ -0,0 +1,80 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/ClassAncestry.h"
+
+#include "Misc/ScopeRWLock.h"
+#include "UObject/Interface.h"
+#include "UObject/ObjectKey.h"
+
+namespace DI
+{
+	namespace Private
+	{
+		struct FClassAncestryRegistry
+		{
+			FRWLock Lock;
+			TMap<TObjectKey<UClass>, TUniquePtr<FClassAncestry>> Ancestries;
+		};
+
+		static FClassAncestryRegistry& GetClassAncestryRegistry()
+		{
+			static FClassAncestryRegistry Registry;
+			return Registry;
+		}
+
+		static TUniquePtr<FClassAncestry> BuildClassAncestry(UClass* Class)
+		{
+			TUniquePtr<FClassAncestry> Ancestry = MakeUnique<FClassAncestry>();
+			for (UClass* SuperClass = Class; SuperClass && SuperClass != UObject::StaticClass(); SuperClass = SuperClass->GetSuperClass())
+			{
+				const int32 SuperClassIndex = Ancestry->SuperClasses.Add(FTypeId(SuperClass));
+				for (const FImplementedInterface& ImplementedInterface : SuperClass->Interfaces)
+				{
+					// Interfaces only list the interface they implement directly, not the interfaces that one inherits from.
+					for (UClass* InterfaceClass = ImplementedInterface.Class;
+					     InterfaceClass && InterfaceClass != UInterface::StaticClass();
+					     InterfaceClass = InterfaceClass->GetSuperClass())
+					{
+						// Super classes come after the classes that derive from them, so the last class that is seen is the least derived one.
+						if (FClassAncestry::FInterface* Interface = Ancestry->Interfaces.FindByPredicate([InterfaceClass](const FClassAncestry::FInterface& Candidate)
+						{
+							return Candidate.Class == InterfaceClass;
+						}))
+						{
+							Interface->SuperClassIndex = SuperClassIndex;
+						}
+						else
+						{
+							Ancestry->Interfaces.Add({FTypeId(InterfaceClass), InterfaceClass, SuperClassIndex});
+						}
+					}
+				}
+			}
+			return Ancestry;
+		}
+	}
+
+	const FClassAncestry& FClassAncestry::Get(UClass* Class)
+	{
+		check(Class);
+		Private::FClassAncestryRegistry& Registry = Private::GetClassAncestryRegistry();
+		{
+			FReadScopeLock ReadLock(Registry.Lock);
+			if (const TUniquePtr<FClassAncestry>* Ancestry = Registry.Ancestries.Find(Class))
+			{
+				return **Ancestry;
+			}
+		}
+
+		// Built outside the lock because building type IDs takes the lock of the type registry.
+		TUniquePtr<FClassAncestry> NewAncestry = Private::BuildClassAncestry(Class);
+		FWriteScopeLock WriteLock(Registry.Lock);
+		TUniquePtr<FClassAncestry>& Ancestry = Registry.Ancestries.FindOrAdd(Class);
+		if (!Ancestry)
+		{
+			Ancestry = MoveTemp(NewAncestry);
+		}
+		return *Ancestry;
+	}
+}
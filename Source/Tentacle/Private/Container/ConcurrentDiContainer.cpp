@@ -0,0 +1,204 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/ConcurrentDiContainer.h"
+
+#include "Async/Async.h"
+
+namespace DI
+{
+	FConcurrentDiContainer::FConcurrentDiContainer()
+		: PublishedBindings(new FFrozenBindingTable())
+	{
+	}
+
+	FConcurrentDiContainer::~FConcurrentDiContainer()
+	{
+		// Whoever destroys us has to make sure that nobody is resolving anymore.
+		delete PublishedBindings.load(std::memory_order_acquire);
+	}
+
+	EBindResult FConcurrentDiContainer::BindSpecific(TRefCountPtr<DI::FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior)
+	{
+		return BindSpecificMany(MakeArrayView(&SpecificBinding, 1), ConflictBehavior);
+	}
+
+	EBindResult FConcurrentDiContainer::BindSpecificMany(TConstArrayView<TRefCountPtr<DI::FBinding>> SpecificBindings, EBindConflictBehavior ConflictBehavior)
+	{
+		EBindResult OverallResult = EBindResult::Bound;
+		TArray<TRefCountPtr<DI::FBinding>> NewBindings;
+		{
+			FScopeLock ScopeLock(&WriteLock);
+			Bindings.Reserve(Bindings.Num() + SpecificBindings.Num());
+			for (const TRefCountPtr<DI::FBinding>& SpecificBinding : SpecificBindings)
+			{
+				DI::FBinding* NewBinding = TryAddBinding(SpecificBinding, ConflictBehavior);
+				if (!NewBinding)
+				{
+					OverallResult = EBindResult::Conflict;
+					continue;
+				}
+				NewBindings.Emplace(NewBinding);
+			}
+
+			if (NewBindings.Num() > 0)
+			{
+				PublishBindings();
+			}
+		}
+
+		if (NewBindings.Num() > 0)
+		{
+			NotifyInstancesBound(MoveTemp(NewBindings));
+		}
+		return OverallResult;
+	}
+
+	TRefCountPtr<DI::FBinding> FConcurrentDiContainer::FindBinding(const FBindingId& BindingId) const
+	{
+		return FindBinding(BindingId.GetKey());
+	}
+
+	TRefCountPtr<DI::FBinding> FConcurrentDiContainer::FindBinding(const FBindingKey& BindingKey) const
+	{
+		return ReadSnapshot([&BindingKey](const FFrozenBindingTable& Snapshot)
+		{
+			// The snapshot keeps the binding alive until we leave, so the reference has to be taken in here.
+			// A writer may replace or remove it as soon as we are gone.
+			// Invalid bindings are removed after garbage collection, so there is no need to check them here.
+			const TRefCountPtr<DI::FBinding>* DependencyBinding = Snapshot.Find(BindingKey);
+			return DependencyBinding ? *DependencyBinding : TRefCountPtr<DI::FBinding>();
+		});
+	}
+
+	const DI::FBinding* FConcurrentDiContainer::FindBindingRaw(const FBindingKey& BindingKey) const
+	{
+		return ReadSnapshot([&BindingKey](const FFrozenBindingTable& Snapshot) -> const DI::FBinding*
+		{
+			const TRefCountPtr<DI::FBinding>* DependencyBinding = Snapshot.Find(BindingKey);
+			return DependencyBinding ? DependencyBinding->GetReference() : nullptr;
+		});
+	}
+
+	void FConcurrentDiContainer::ForEachBinding(const FBindingKey& BindingKey, TFunctionRef<void(const DI::FBinding&)> Visitor) const
+	{
+		// Visit outside of the snapshot so a visitor that binds does not wait for itself.
+		if (const TRefCountPtr<DI::FBinding> Binding = FindBinding(BindingKey))
+		{
+			Visitor(*Binding);
+		}
+	}
+
+	FBindingSubscriptionHandle FConcurrentDiContainer::Subscribe(const FBindingId& BindingId, FBindingSubscriptionList::FOnInstanceBound&& Callback, const UObject* WaitingObject) const
+	{
+		check(IsInGameThread());
+		if (WaitingObject)
+		{
+			EnsureSweptAfterGarbageCollection();
+		}
+		return Subscriptions.Subscribe(BindingId.GetKey(), MoveTemp(Callback), WaitingObject);
+	}
+
+	bool FConcurrentDiContainer::Unsubscribe(const FBindingId& BindingId, FBindingSubscriptionHandle Handle) const
+	{
+		check(IsInGameThread());
+		return Subscriptions.Unsubscribe(BindingId.GetKey(), Handle) != EUnsubscribeResult::NotSubscribed;
+	}
+
+	void FConcurrentDiContainer::AddReferencedObjects(FReferenceCollector& Collector)
+	{
+		FScopeLock ScopeLock(&WriteLock);
+		Bindings.AddReferencedObjects(Collector);
+	}
+
+	TBindingHelper<FConcurrentDiContainer> FConcurrentDiContainer::Bind()
+	{
+		return TBindingHelper<FConcurrentDiContainer>(*this);
+	}
+
+	TResolveHelper<FConcurrentDiContainer> FConcurrentDiContainer::Resolve() const
+	{
+		return TResolveHelper<FConcurrentDiContainer>(*this);
+	}
+
+	TInjector<FConcurrentDiContainer> FConcurrentDiContainer::Inject()
+	{
+		return TInjector<FConcurrentDiContainer>(*this);
+	}
+
+	void FConcurrentDiContainer::RemoveInvalidBindings()
+	{
+		FScopeLock ScopeLock(&WriteLock);
+		if (RemoveInvalidBindingsFromTable(Bindings) > 0)
+		{
+			PublishBindings();
+		}
+	}
+
+	void FConcurrentDiContainer::RemoveAbandonedWaiters(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks)
+	{
+		// Subscriptions are only touched on the game thread, which is where garbage collection finishes as well.
+		check(IsInGameThread());
+		Subscriptions.RemoveAbandonedWaiters(OutAbandonedCallbacks);
+	}
+
+	void FConcurrentDiContainer::DeliverInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings)
+	{
+		check(IsInGameThread());
+		for (const DI::FBinding* NewBinding : NewBindings)
+		{
+			Subscriptions.NotifyInstanceBound(*NewBinding);
+		}
+	}
+
+	DI::FBinding* FConcurrentDiContainer::TryAddBinding(const TRefCountPtr<DI::FBinding>& SpecificBinding, EBindConflictBehavior ConflictBehavior)
+	{
+		// Sets are copied on write because readers may still be iterating the bound one.
+		// Those readers hold a reference to it, which keeps it alive until they are done.
+		return TryAddBindingToTable(Bindings, SpecificBinding, ConflictBehavior, true);
+	}
+
+	void FConcurrentDiContainer::PublishBindings()
+	{
+		FFrozenBindingTable* OldSnapshot = PublishedBindings.exchange(new FFrozenBindingTable(Bindings), std::memory_order_acq_rel);
+		WaitForReaders();
+		delete OldSnapshot;
+	}
+
+	void FConcurrentDiContainer::WaitForReaders()
+	{
+		// Readers that register from now on will see the new epoch and therefore the new snapshot.
+		const uint32 OldEpoch = ReadEpoch.fetch_add(1);
+		for (FReaderStripe& ReaderStripe : ReaderStripes)
+		{
+			while (ReaderStripe.NumReaders[OldEpoch & 1].load() != 0)
+			{
+				FPlatformProcess::Yield();
+			}
+		}
+	}
+
+	void FConcurrentDiContainer::NotifyInstancesBound(TArray<TRefCountPtr<DI::FBinding>> NewBindings)
+	{
+		if (IsInGameThread())
+		{
+			TArray<const DI::FBinding*, TInlineAllocator<32>> NewBindingPtrs;
+			NewBindingPtrs.Reserve(NewBindings.Num());
+			for (const TRefCountPtr<DI::FBinding>& NewBinding : NewBindings)
+			{
+				NewBindingPtrs.Add(NewBinding.GetReference());
+			}
+			DispatchInstancesBound(NewBindingPtrs);
+			return;
+		}
+
+		checkf(DoesSharedInstanceExist(), TEXT("FConcurrentDiContainer has to be created with MakeShared to be bound from other threads."));
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = AsWeak(), NewBindings = MoveTemp(NewBindings)]() mutable
+		{
+			if (TSharedPtr<FConcurrentDiContainer> PinnedThis = WeakThis.Pin())
+			{
+				PinnedThis->NotifyInstancesBound(MoveTemp(NewBindings));
+			}
+		});
+	}
+}
@@ -5,34 +5,40 @@
 
 namespace DI
 {
-	bool FDiContainer::Unsubscribe(const FBindingId& BindingId, FDelegateHandle DelegateHandle) const
+	bool FDiContainer::Unsubscribe(const FBindingId& BindingId, FBindingSubscriptionHandle Handle) const
 	{
-		return Subscriptions.Unsubscribe(BindingId, DelegateHandle);
+		return Subscriptions.Unsubscribe(BindingId.GetKey(), Handle) != EUnsubscribeResult::NotSubscribed;
 	}
 
 	void FDiContainer::AddReferencedObjects(FReferenceCollector& Collector)
 	{
-		for (auto& [BindingId, Binding] : Bindings)
-		{
-			Binding->AddReferencedObjects(Collector);
-		}
+		Bindings.AddReferencedObjects(Collector);
 	}
 
-	TSharedPtr<DI::FBinding> FDiContainer::FindBinding(const FBindingId& BindingId) const
+	TRefCountPtr<DI::FBinding> FDiContainer::FindBinding(const FBindingId& BindingId) const
 	{
-		if (const TSharedRef<DI::FBinding>* DependencyBinding = Bindings.Find(BindingId))
-		{
-			if ((*DependencyBinding)->IsValid())
-			{
-				return *DependencyBinding;
-			}
-		}
-		return nullptr;
+		return FindBinding(BindingId.GetKey());
 	}
 
-	FBindingSubscriptionList::FOnInstanceBound& FDiContainer::Subscribe(const FBindingId& BindingId) const
+	TRefCountPtr<DI::FBinding> FDiContainer::FindBinding(const FBindingKey& BindingKey) const
 	{
-		return Subscriptions.SubscribeOnce(BindingId);
+		return TRefCountPtr<DI::FBinding>(const_cast<DI::FBinding*>(FindBindingRaw(BindingKey)));
+	}
+
+	const DI::FBinding* FDiContainer::FindBindingRaw(const FBindingKey& BindingKey) const
+	{
+		// Invalid bindings are removed after garbage collection, so everything in the table can be trusted.
+		const TRefCountPtr<DI::FBinding>* DependencyBinding = Bindings.Find(BindingKey);
+		return DependencyBinding ? DependencyBinding->GetReference() : nullptr;
+	}
+
+	FBindingSubscriptionHandle FDiContainer::Subscribe(const FBindingId& BindingId, FBindingSubscriptionList::FOnInstanceBound&& Callback, const UObject* WaitingObject) const
+	{
+		if (WaitingObject)
+		{
+			EnsureSweptAfterGarbageCollection();
+		}
+		return Subscriptions.Subscribe(BindingId.GetKey(), MoveTemp(Callback), WaitingObject);
 	}
 
 	TBindingHelper<FDiContainer> FDiContainer::Bind()
@@ -51,20 +57,63 @@ namespace DI
 	}
 
 	EBindResult FDiContainer::BindSpecific(
-		TSharedRef<DI::FBinding> SpecificBinding,
+		TRefCountPtr<DI::FBinding> SpecificBinding,
+		EBindConflictBehavior ConflictBehavior)
+	{
+		const DI::FBinding* NewBinding = TryAddBinding(SpecificBinding, ConflictBehavior);
+		if (!NewBinding)
+			return EBindResult::Conflict;
+
+		DispatchInstancesBound(MakeArrayView(&NewBinding, 1));
+		return EBindResult::Bound;
+	}
+
+	EBindResult FDiContainer::BindSpecificMany(
+		TConstArrayView<TRefCountPtr<DI::FBinding>> SpecificBindings,
 		EBindConflictBehavior ConflictBehavior)
 	{
-		FBindingId BindingId = SpecificBinding->GetId();
-		if (TSharedRef<FBinding>* Binding = Bindings.Find(BindingId))
+		EBindResult OverallResult = EBindResult::Bound;
+		TArray<const DI::FBinding*, TInlineAllocator<32>> NewBindings;
+		Bindings.Reserve(Bindings.Num() + SpecificBindings.Num());
+		for (const TRefCountPtr<DI::FBinding>& SpecificBinding : SpecificBindings)
 		{
-			if ((*Binding)->IsValid())
+			const DI::FBinding* NewBinding = TryAddBinding(SpecificBinding, ConflictBehavior);
+			if (!NewBinding)
 			{
-				HandleBindingConflict(BindingId, ConflictBehavior);
-				return EBindResult::Conflict;
+				OverallResult = EBindResult::Conflict;
+				continue;
 			}
+			NewBindings.Add(NewBinding);
 		}
-		Bindings.Emplace(BindingId, SpecificBinding);
-		Subscriptions.NotifyInstanceBound(*SpecificBinding);
-		return EBindResult::Bound;
+
+		// Notify only after all bindings are in, so subscribers can already resolve the rest of the batch.
+		if (NewBindings.Num() > 0)
+		{
+			DispatchInstancesBound(NewBindings);
+		}
+		return OverallResult;
+	}
+
+	void FDiContainer::DeliverInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings)
+	{
+		for (const DI::FBinding* NewBinding : NewBindings)
+		{
+			Subscriptions.NotifyInstanceBound(*NewBinding);
+		}
+	}
+
+	void FDiContainer::RemoveInvalidBindings()
+	{
+		RemoveInvalidBindingsFromTable(Bindings);
+	}
+
+	void FDiContainer::RemoveAbandonedWaiters(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks)
+	{
+		Subscriptions.RemoveAbandonedWaiters(OutAbandonedCallbacks);
+	}
+
+	DI::FBinding* FDiContainer::TryAddBinding(const TRefCountPtr<DI::FBinding>& SpecificBinding, EBindConflictBehavior ConflictBehavior)
+	{
+		return TryAddBindingToTable(Bindings, SpecificBinding, ConflictBehavior);
 	}
 }
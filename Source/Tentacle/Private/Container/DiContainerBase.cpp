@@ -0,0 +1,343 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/DiContainerBase.h"
+
+#include "Algo/Reverse.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace DI::Private
+{
+	/** Containers that have to be swept after garbage collection. */
+	FCriticalSection GSweptContainersLock;
+	DI::FDiContainerBase* GSweptContainers = nullptr;
+	/** Container that the running sweep visits next. Containers that are destroyed during the sweep move it past themselves. */
+	DI::FDiContainerBase* GNextContainerToSweep = nullptr;
+	FDelegateHandle GPostGarbageCollectHandle;
+}
+
+DI::FDiContainerBase::FDiContainerBase() = default;
+
+DI::FDiContainerBase::FDiContainerBase(const FDiContainerBase& Other)
+	: NotificationMode(Other.NotificationMode)
+	  , bHasExpirableBindings(Other.bHasExpirableBindings)
+	  , BindingArena(Other.BindingArena.load(std::memory_order_acquire))
+{
+	if (FBindingArena* Arena = BindingArena.load(std::memory_order_relaxed))
+	{
+		Arena->AddRef();
+	}
+	if (bHasExpirableBindings)
+	{
+		EnsureSweptAfterGarbageCollection();
+	}
+}
+
+DI::FDiContainerBase& DI::FDiContainerBase::operator=(const FDiContainerBase& Other)
+{
+	// Keep our own registration, the one of Other is bound to Other.
+	// Queued notifications belong to the bindings and subscriptions that are being replaced.
+	NotificationMode = Other.NotificationMode;
+	QueuedNotifications.Reset();
+	if (EndFrameHandle.IsValid())
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		EndFrameHandle.Reset();
+	}
+	FBindingArena* OtherArena = Other.BindingArena.load(std::memory_order_acquire);
+	if (OtherArena)
+	{
+		OtherArena->AddRef();
+	}
+	if (FBindingArena* OldArena = BindingArena.exchange(OtherArena, std::memory_order_acq_rel))
+	{
+		OldArena->Release();
+	}
+	bHasExpirableBindings = Other.bHasExpirableBindings;
+	if (bHasExpirableBindings)
+	{
+		EnsureSweptAfterGarbageCollection();
+	}
+	return *this;
+}
+
+DI::FDiContainerBase::~FDiContainerBase()
+{
+	if (bIsSweptAfterGarbageCollection.load(std::memory_order_acquire))
+	{
+		using namespace DI::Private;
+		FScopeLock ScopeLock(&GSweptContainersLock);
+		if (GNextContainerToSweep == this)
+		{
+			GNextContainerToSweep = NextSweptContainer;
+		}
+		(PrevSweptContainer ? PrevSweptContainer->NextSweptContainer : GSweptContainers) = NextSweptContainer;
+		if (NextSweptContainer)
+		{
+			NextSweptContainer->PrevSweptContainer = PrevSweptContainer;
+		}
+	}
+	if (EndFrameHandle.IsValid())
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	}
+	if (FBindingArena* Arena = BindingArena.load(std::memory_order_acquire))
+	{
+		Arena->Release();
+	}
+}
+
+DI::FBindingArena* DI::FDiContainerBase::CreateBindingArena() const
+{
+	FBindingArena* NewArena = new FBindingArena();
+	NewArena->AddRef();
+	FBindingArena* ExpectedArena = nullptr;
+	if (BindingArena.compare_exchange_strong(ExpectedArena, NewArena, std::memory_order_acq_rel))
+	{
+		return NewArena;
+	}
+	// Another thread has been faster.
+	NewArena->Release();
+	return ExpectedArena;
+}
+
+void DI::FDiContainerBase::SetNotificationMode(EBindingNotificationMode Mode)
+{
+	check(IsInGameThread());
+	NotificationMode = Mode;
+	if (Mode == EBindingNotificationMode::Immediate)
+	{
+		FlushNotifications();
+	}
+}
+
+void DI::FDiContainerBase::FlushNotifications()
+{
+	check(IsInGameThread());
+	if (EndFrameHandle.IsValid())
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		EndFrameHandle.Reset();
+	}
+	if (QueuedNotifications.Num() == 0)
+		return;
+
+	// Subscribers may bind again while being notified, which queues into a fresh array.
+	const TArray<TRefCountPtr<DI::FBinding>> Notifications = MoveTemp(QueuedNotifications);
+
+	// Only the last binding of every key is delivered. It has to be valid, it may have been bound a while ago.
+	TSet<FBindingKey, DefaultKeyFuncs<FBindingKey>, TInlineSetAllocator<32>> DeliveredKeys;
+	TArray<const DI::FBinding*, TInlineAllocator<32>> NewBindings;
+	for (int32 NotificationIndex = Notifications.Num() - 1; NotificationIndex >= 0; --NotificationIndex)
+	{
+		const DI::FBinding* Binding = Notifications[NotificationIndex].GetReference();
+		bool bIsAlreadyDelivered = false;
+		DeliveredKeys.Add(Binding->GetId().GetKey(), &bIsAlreadyDelivered);
+		if (!bIsAlreadyDelivered && Binding->IsValid())
+		{
+			NewBindings.Add(Binding);
+		}
+	}
+	Algo::Reverse(NewBindings);
+
+	DeliverInstancesBound(NewBindings);
+}
+
+void DI::FDiContainerBase::DispatchInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings)
+{
+	if (NotificationMode == EBindingNotificationMode::Immediate)
+	{
+		DeliverInstancesBound(NewBindings);
+		return;
+	}
+
+	for (const DI::FBinding* NewBinding : NewBindings)
+	{
+		QueuedNotifications.Emplace(const_cast<DI::FBinding*>(NewBinding));
+	}
+	if (!EndFrameHandle.IsValid())
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FDiContainerBase::FlushNotifications);
+	}
+}
+
+void DI::FDiContainerBase::StartGarbageCollectionSweeps()
+{
+	check(!Private::GPostGarbageCollectHandle.IsValid());
+	Private::GPostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&FDiContainerBase::SweepAfterGarbageCollection);
+}
+
+void DI::FDiContainerBase::StopGarbageCollectionSweeps()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(Private::GPostGarbageCollectHandle);
+	Private::GPostGarbageCollectHandle.Reset();
+}
+
+void DI::FDiContainerBase::EnsureSweptAfterGarbageCollection() const
+{
+	if (bIsSweptAfterGarbageCollection.load(std::memory_order_acquire))
+		return;
+
+	using namespace DI::Private;
+	FScopeLock ScopeLock(&GSweptContainersLock);
+	if (bIsSweptAfterGarbageCollection.load(std::memory_order_relaxed))
+		return;
+
+	FDiContainerBase* MutableThis = const_cast<FDiContainerBase*>(this);
+	NextSweptContainer = GSweptContainers;
+	if (GSweptContainers)
+	{
+		GSweptContainers->PrevSweptContainer = MutableThis;
+	}
+	GSweptContainers = MutableThis;
+	bIsSweptAfterGarbageCollection.store(true, std::memory_order_release);
+}
+
+void DI::FDiContainerBase::SweepAfterGarbageCollection()
+{
+	check(IsInGameThread());
+	using namespace DI::Private;
+	FScopeLock ScopeLock(&GSweptContainersLock);
+	// Containers that register during the sweep are added in front of the cursor and wait for the next garbage collection.
+	for (FDiContainerBase* Container = GSweptContainers; Container; Container = GNextContainerToSweep)
+	{
+		GNextContainerToSweep = Container->NextSweptContainer;
+		// Sweeping cancels futures, whose continuations may create or destroy containers, including the swept one.
+		// So the callbacks that own the futures are destroyed after the container is done and before the lock is taken again.
+		FScopeUnlock ScopeUnlock(&GSweptContainersLock);
+		TArray<FBindingSubscriptionList::FOnInstanceBound> AbandonedCallbacks;
+		Container->OnPostGarbageCollect(AbandonedCallbacks);
+	}
+	GNextContainerToSweep = nullptr;
+}
+
+void DI::FDiContainerBase::OnPostGarbageCollect(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks)
+{
+	if (bHasExpirableBindings)
+	{
+		RemoveInvalidBindings();
+	}
+	RemoveAbandonedWaiters(OutAbandonedCallbacks);
+}
+
+int32 DI::FDiContainerBase::RemoveInvalidBindingsFromTable(FBindingTable& Table)
+{
+	TArray<FBindingKey, TInlineAllocator<16>> InvalidKeys;
+	for (const auto& [BindingKey, Binding] : Table)
+	{
+		if (Binding->CanExpire() && !Binding->IsValid())
+		{
+			InvalidKeys.Add(BindingKey);
+		}
+	}
+	for (const FBindingKey& InvalidKey : InvalidKeys)
+	{
+		Table.Remove(InvalidKey);
+	}
+	return InvalidKeys.Num();
+}
+
+DI::EBindResult DI::FDiContainerBase::BindSpecificMany(TConstArrayView<TRefCountPtr<DI::FBinding>> SpecificBindings, EBindConflictBehavior ConflictBehavior)
+{
+	EBindResult OverallResult = EBindResult::Bound;
+	for (const TRefCountPtr<DI::FBinding>& SpecificBinding : SpecificBindings)
+	{
+		const EBindResult Result = BindSpecific(SpecificBinding, ConflictBehavior);
+		if (OverallResult == EBindResult::Bound)
+		{
+			OverallResult = Result;
+		}
+	}
+	return OverallResult;
+}
+
+
+void DI::FDiContainerBase::FindBindings(TConstArrayView<FBindingId> BindingIds, TArrayView<const DI::FBinding*> OutBindings) const
+{
+	check(BindingIds.Num() == OutBindings.Num());
+	for (int32 BindingIndex = 0; BindingIndex < BindingIds.Num(); ++BindingIndex)
+	{
+		OutBindings[BindingIndex] = FindBindingRaw(BindingIds[BindingIndex].GetKey());
+	}
+}
+
+void DI::FDiContainerBase::ForEachBinding(const FBindingKey& BindingKey, TFunctionRef<void(const DI::FBinding&)> Visitor) const
+{
+	if (const DI::FBinding* Binding = FindBindingRaw(BindingKey))
+	{
+		Visitor(*Binding);
+	}
+}
+
+DI::FBinding* DI::FDiContainerBase::TryAddBindingToTable(
+	FBindingTable& Table,
+	const TRefCountPtr<DI::FBinding>& SpecificBinding,
+	EBindConflictBehavior ConflictBehavior,
+	bool bCopyOnWrite)
+{
+	if (SpecificBinding->CanExpire() && !bHasExpirableBindings)
+	{
+		bHasExpirableBindings = true;
+		EnsureSweptAfterGarbageCollection();
+	}
+
+	const FBindingId& BindingId = SpecificBinding->GetId();
+	if (TRefCountPtr<FBinding>* Binding = Table.Find(BindingId.GetKey()))
+	{
+		if (BindingId.IsSet())
+		{
+			const FBindingSet& NewSet = static_cast<const FBindingSet&>(*SpecificBinding);
+			FBindingSet& BoundSet = static_cast<FBindingSet&>(**Binding);
+			if (!bCopyOnWrite)
+			{
+				BoundSet.Append(NewSet);
+				return &BoundSet;
+			}
+
+			TRefCountPtr<FBindingSet> MergedSet = BoundSet.Clone(GetBindingArena());
+			MergedSet->Append(NewSet);
+			Table.Emplace(BindingId.GetKey(), TRefCountPtr<FBinding>(MergedSet.GetReference()));
+			return MergedSet.GetReference();
+		}
+
+		if ((*Binding)->IsValid())
+		{
+			HandleBindingConflict(BindingId, ConflictBehavior);
+			return nullptr;
+		}
+	}
+	Table.Emplace(BindingId.GetKey(), SpecificBinding);
+	return SpecificBinding.GetReference();
+}
+
+void DI::FConnectedDiContainer::RetryPendingWaits(TConstArrayView<FLookupTable> NewAncestorTables) const
+{
+	// Only bindings of the new ancestors can have become reachable.
+	// They may still be shadowed by a binding in the subtree whose notification is queued, which every waiting container checks on its own.
+	TArray<const DI::FBinding*, TInlineAllocator<8>> FoundBindings;
+	GetSubtreePendingKeys().ForEachKey([&](const FBindingKey& BindingKey)
+	{
+		for (const FLookupTable& LookupTable : NewAncestorTables)
+		{
+			if (!LookupTable.Filter->MightContain(BindingKey))
+				continue;
+
+			if (const TRefCountPtr<DI::FBinding>* Binding = LookupTable.Find(BindingKey))
+			{
+				// Bindings of destroyed UObjects stay until the next sweep, nobody should be fulfilled with them.
+				if ((*Binding)->IsValid())
+				{
+					FoundBindings.Add(Binding->GetReference());
+				}
+				return;
+			}
+		}
+	});
+
+	if (FoundBindings.Num() > 0)
+	{
+		NotifyInstancesBound(FoundBindings);
+	}
+}
@@ -5,21 +5,56 @@
 
 #include "Tentacle.h"
 
+DI::FForkingDiContainer::~FForkingDiContainer()
+{
+	// Nobody in our subtree is going to wait for anything anymore.
+	if (!SubtreePendingKeys.IsEmpty())
+	{
+		const TArray<FBindingKey> PendingKeys = SubtreePendingKeys.GetKeys();
+		for (const FParentContainer& Parent : ParentContainers)
+		{
+			if (TSharedPtr<FConnectedDiContainer> PinnedParent = Parent.WeakContainer.Pin())
+			{
+				PinnedParent->RemoveSubtreePendingKeys(PendingKeys);
+			}
+		}
+	}
+
+	// Our children may have cached bindings of our parents and still point to their tables through us.
+	if (ChildrenContainers.Num() > 0)
+	{
+		// Our weak pointer has already expired, so our children will drop us from their caches.
+		for (const TWeakPtr<FConnectedDiContainer>& WeakChildContainer : ChildrenContainers)
+		{
+			if (TSharedPtr<FConnectedDiContainer> ChildContainer = WeakChildContainer.Pin())
+			{
+				ChildContainer->RebuildAncestorCaches();
+			}
+		}
+	}
+}
+
 void DI::FForkingDiContainer::AddParentContainer(TSharedRef<FConnectedDiContainer> DiContainer, int32 Priority)
 {
 	// Remove all existing instances disregarding priority.
 	// This will cause the priority to be "overwritten" if you add the same DiContainer with a different priority.
-	ParentContainers.RemoveAll([DiContainer](const auto& PrioritizedParent)
+	const bool bIsNewParent = ParentContainers.RemoveAll([DiContainer](const auto& PrioritizedParent)
 	{
-		return PrioritizedParent.Value == DiContainer;
-	});
+		return PrioritizedParent.WeakContainer == DiContainer;
+	}) == 0;
 
-	ParentContainers.Add({Priority, MoveTemp(DiContainer)});
+	ParentContainers.Add({Priority, DiContainer});
 	ParentContainers.StableSort([](const auto& Lhs, const auto& Rhs)
 	{
-		return Lhs.Key >= Rhs.Key;
+		return Lhs.Priority >= Rhs.Priority;
 	});
-	
+	RebuildAncestorCaches();
+
+	// Has to happen before connecting, which resolves pending waits and removes their keys again.
+	if (bIsNewParent)
+	{
+		DiContainer->AddSubtreePendingKeys(SubtreePendingKeys.GetKeys());
+	}
 	if (!DiContainer->TryConnectSubcontainer(AsShared()))
 	{
 		UE_LOG(LogDependencyInjection, Error, TEXT("FForkingDiContainer::AddParentContainer: Failed to connect to parent container."));
@@ -28,28 +63,31 @@ void DI::FForkingDiContainer::AddParentContainer(TSharedRef<FConnectedDiContaine
 
 void DI::FForkingDiContainer::RemoveParentContainer(TWeakPtr<FConnectedDiContainer> DiContainer)
 {
-	for (auto It = ParentContainers.CreateIterator(); It; ++It)
+	const bool bWasParent = ParentContainers.RemoveAll([&DiContainer](const auto& PrioritizedParent)
 	{
-		if (It->Value != DiContainer)
-			continue;
+		return PrioritizedParent.WeakContainer == DiContainer;
+	}) > 0;
+	if (!bWasParent)
+		return;
 
-		It.RemoveCurrent();
+	// Rebuilding also removes parents that have been destroyed, so it must not run while iterating over the parents.
+	RebuildAncestorCaches();
 
-		TSharedPtr<FConnectedDiContainer> PinnedParent = DiContainer.Pin();
-		if (!PinnedParent)
-			continue;
+	TSharedPtr<FConnectedDiContainer> PinnedParent = DiContainer.Pin();
+	if (!PinnedParent)
+		return;
 
-		if (!PinnedParent->TryDisconnectSubcontainer(AsShared()))
-		{
-			UE_LOG(LogDependencyInjection, Warning, TEXT("FForkingDiContainer::AddParentContainer: Failed to disconnect from parent container."));
-		}
+	PinnedParent->RemoveSubtreePendingKeys(SubtreePendingKeys.GetKeys());
+	if (!PinnedParent->TryDisconnectSubcontainer(AsShared()))
+	{
+		UE_LOG(LogDependencyInjection, Warning, TEXT("FForkingDiContainer::RemoveParentContainer: Failed to disconnect from parent container."));
 	}
 }
 
 bool DI::FForkingDiContainer::TryConnectSubcontainer(TSharedRef<FConnectedDiContainer> ConnectedDiContainer)
 {
 	ChildrenContainers.AddUnique(ConnectedDiContainer);
-	ConnectedDiContainer->RetryAllPendingWaits();
+	ConnectedDiContainer->RetryPendingWaits(GetLookupTables());
 	return true;
 }
 
@@ -58,8 +96,20 @@ bool DI::FForkingDiContainer::TryDisconnectSubcontainer(TSharedRef<FConnectedDiC
 	return ChildrenContainers.Remove(ConnectedDiContainer) > 0;
 }
 
-void DI::FForkingDiContainer::NotifyInstanceBound(const DI::FBinding& NewBinding) const
+void DI::FForkingDiContainer::NotifyInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) const
 {
+	// We have no subscribers of our own, so only bindings that our children wait for are of interest.
+	TArray<const DI::FBinding*, TInlineAllocator<32>> ChildBindings;
+	for (const DI::FBinding* NewBinding : NewBindings)
+	{
+		if (SubtreePendingKeys.Contains(NewBinding->GetId().GetKey()))
+		{
+			ChildBindings.Add(NewBinding);
+		}
+	}
+	if (ChildBindings.Num() == 0)
+		return;
+
 	for (auto ChildrenContainerIt = ChildrenContainers.CreateIterator(); ChildrenContainerIt; ++ChildrenContainerIt)
 	{
 		TSharedPtr<FConnectedDiContainer> ChainedDiContainer = ChildrenContainerIt->Pin();
@@ -69,40 +119,92 @@ void DI::FForkingDiContainer::NotifyInstanceBound(const DI::FBinding& NewBinding
 			continue;
 		}
 
-		ChainedDiContainer->NotifyInstanceBound(NewBinding);
+		ChainedDiContainer->NotifyInstancesBound(ChildBindings);
 	}
 }
 
-void DI::FForkingDiContainer::RetryAllPendingWaits() const
+TConstArrayView<DI::FLookupTable> DI::FForkingDiContainer::GetLookupTables() const
+{
+	return LookupTables;
+}
+
+void DI::FForkingDiContainer::RebuildAncestorCaches() const
 {
+	LookupTables.Reset();
+	for (auto It = ParentContainers.CreateIterator(); It; ++It)
+	{
+		TSharedPtr<FConnectedDiContainer> ParentDiContainer = It->WeakContainer.Pin();
+		if (!ParentDiContainer.IsValid())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		for (const FLookupTable& LookupTable : ParentDiContainer->GetLookupTables())
+		{
+			// Diamonds would otherwise make us look into shared ancestors once per path.
+			LookupTables.AddUnique(LookupTable);
+		}
+	}
+
 	for (auto ChildrenContainerIt = ChildrenContainers.CreateIterator(); ChildrenContainerIt; ++ChildrenContainerIt)
 	{
-		TSharedPtr<FConnectedDiContainer> ChainedDiContainer = ChildrenContainerIt->Pin();
-		if (!ChainedDiContainer.IsValid())
+		TSharedPtr<FConnectedDiContainer> ChildContainer = ChildrenContainerIt->Pin();
+		if (!ChildContainer.IsValid())
 		{
 			ChildrenContainerIt.RemoveCurrent();
 			continue;
 		}
 
-		ChainedDiContainer->RetryAllPendingWaits();
+		ChildContainer->RebuildAncestorCaches();
 	}
 }
 
-TSharedPtr<DI::FBinding> DI::FForkingDiContainer::FindConnectedBinding(const FBindingId& BindingId) const
+void DI::FForkingDiContainer::AddSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const
 {
-	for (auto It = ParentContainers.CreateIterator(); It; ++It)
+	TArray<FBindingKey, TInlineAllocator<8>> NewPendingKeys;
+	for (const FBindingKey& BindingKey : BindingKeys)
 	{
-		TSharedPtr<FConnectedDiContainer> ParentDiContainer = It->Value.Pin();
-		if (!ParentDiContainer.IsValid())
+		if (SubtreePendingKeys.Add(BindingKey))
 		{
-			It.RemoveCurrent();
-			continue;
+			NewPendingKeys.Add(BindingKey);
 		}
+	}
+	if (NewPendingKeys.Num() == 0)
+		return;
 
-		if (TSharedPtr<DI::FBinding> Binding = ParentDiContainer->FindConnectedBinding(BindingId))
+	for (const FParentContainer& Parent : ParentContainers)
+	{
+		if (TSharedPtr<FConnectedDiContainer> PinnedParent = Parent.WeakContainer.Pin())
 		{
-			return Binding;
+			PinnedParent->AddSubtreePendingKeys(NewPendingKeys);
 		}
 	}
-	return {};
 }
+
+const DI::FPendingKeyIndex& DI::FForkingDiContainer::GetSubtreePendingKeys() const
+{
+	return SubtreePendingKeys;
+}
+
+void DI::FForkingDiContainer::RemoveSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const
+{
+	TArray<FBindingKey, TInlineAllocator<8>> RemovedPendingKeys;
+	for (const FBindingKey& BindingKey : BindingKeys)
+	{
+		if (SubtreePendingKeys.Remove(BindingKey))
+		{
+			RemovedPendingKeys.Add(BindingKey);
+		}
+	}
+	if (RemovedPendingKeys.Num() == 0)
+		return;
+
+	for (const FParentContainer& Parent : ParentContainers)
+	{
+		if (TSharedPtr<FConnectedDiContainer> PinnedParent = Parent.WeakContainer.Pin())
+		{
+			PinnedParent->RemoveSubtreePendingKeys(RemovedPendingKeys);
+		}
+	}
+}
\ No newline at end of file
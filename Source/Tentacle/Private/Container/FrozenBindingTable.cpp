@@ -0,0 +1,179 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/FrozenBindingTable.h"
+
+namespace DI
+{
+	namespace FrozenBindingTable
+	{
+		/** Keys per bucket on average. Smaller buckets make displacements easier to find but need more displacements. */
+		constexpr uint32 AverageBucketSize = 4;
+
+		/** Displacements that are tried per bucket before the number of slots is increased. */
+		constexpr uint32 MaxDisplacement = 1 << 16;
+	}
+
+	FFrozenBindingTable::FFrozenBindingTable(const FBindingTable& BindingTable)
+	{
+		Build(BindingTable);
+	}
+
+	FFrozenBindingTable::~FFrozenBindingTable()
+	{
+		Release();
+	}
+
+	FFrozenBindingTable::FFrozenBindingTable(FFrozenBindingTable&& Other)
+	{
+		*this = MoveTemp(Other);
+	}
+
+	FFrozenBindingTable& FFrozenBindingTable::operator=(FFrozenBindingTable&& Other)
+	{
+		if (this == &Other)
+			return *this;
+
+		Release();
+		Memory = Other.Memory;
+		Slots = Other.Slots;
+		Displacements = Other.Displacements;
+		NumSlots = Other.NumSlots;
+		NumBuckets = Other.NumBuckets;
+		NumBindings = Other.NumBindings;
+
+		Other.Memory = nullptr;
+		Other.Slots = nullptr;
+		Other.Displacements = nullptr;
+		Other.NumSlots = 0;
+		Other.NumBuckets = 0;
+		Other.NumBindings = 0;
+		return *this;
+	}
+
+	void FFrozenBindingTable::Build(const FBindingTable& BindingTable)
+	{
+		TArray<const FSlot*> Entries;
+		Entries.Reserve(BindingTable.Num());
+		for (const FSlot& Slot : BindingTable)
+		{
+			Entries.Add(&Slot);
+		}
+		if (Entries.Num() == 0)
+			return;
+
+		const uint32 NumEntries = static_cast<uint32>(Entries.Num());
+		const uint32 NewNumBuckets = (NumEntries + FrozenBindingTable::AverageBucketSize - 1) / FrozenBindingTable::AverageBucketSize;
+		TArray<TArray<int32, TInlineAllocator<FrozenBindingTable::AverageBucketSize * 2>>> Buckets;
+		Buckets.SetNum(NewNumBuckets);
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			Buckets[GetBucketIndex(Entries[EntryIndex]->Key.GetHash(), NewNumBuckets)].Add(EntryIndex);
+		}
+
+		// Place the biggest buckets first while there are still many free slots.
+		TArray<int32> BucketOrder;
+		BucketOrder.Reserve(NewNumBuckets);
+		for (uint32 BucketIndex = 0; BucketIndex < NewNumBuckets; ++BucketIndex)
+		{
+			BucketOrder.Add(static_cast<int32>(BucketIndex));
+		}
+		BucketOrder.StableSort([&Buckets](int32 A, int32 B)
+		{
+			return Buckets[A].Num() > Buckets[B].Num();
+		});
+
+		// Load factor of 0.8 keeps the search for displacements short.
+		uint32 NewNumSlots = NumEntries + NumEntries / 4 + 1;
+		TArray<uint32> NewDisplacements;
+		TArray<uint32> EntrySlots;
+		TBitArray<> OccupiedSlots;
+		bool bFoundAllDisplacements = false;
+		while (!bFoundAllDisplacements)
+		{
+			NewDisplacements.Init(0, NewNumBuckets);
+			EntrySlots.Init(0, NumEntries);
+			OccupiedSlots.Init(false, NewNumSlots);
+			bFoundAllDisplacements = true;
+
+			for (const int32 BucketIndex : BucketOrder)
+			{
+				const auto& Bucket = Buckets[BucketIndex];
+				if (Bucket.Num() == 0)
+					continue;
+
+				bool bFoundDisplacement = false;
+				for (uint32 Displacement = 0; Displacement < FrozenBindingTable::MaxDisplacement && !bFoundDisplacement; ++Displacement)
+				{
+					TArray<uint32, TInlineAllocator<FrozenBindingTable::AverageBucketSize * 2>> BucketSlots;
+					bFoundDisplacement = true;
+					for (const int32 EntryIndex : Bucket)
+					{
+						const uint32 SlotIndex = GetSlotIndex(Entries[EntryIndex]->Key, Displacement, NewNumSlots);
+						if (OccupiedSlots[SlotIndex] || BucketSlots.Contains(SlotIndex))
+						{
+							bFoundDisplacement = false;
+							break;
+						}
+						BucketSlots.Add(SlotIndex);
+					}
+
+					if (bFoundDisplacement)
+					{
+						NewDisplacements[BucketIndex] = Displacement;
+						for (int32 BucketEntryIndex = 0; BucketEntryIndex < Bucket.Num(); ++BucketEntryIndex)
+						{
+							OccupiedSlots[BucketSlots[BucketEntryIndex]] = true;
+							EntrySlots[Bucket[BucketEntryIndex]] = BucketSlots[BucketEntryIndex];
+						}
+					}
+				}
+
+				if (!bFoundDisplacement)
+				{
+					// Practically unreachable, but more slots always make the search easier.
+					NewNumSlots *= 2;
+					bFoundAllDisplacements = false;
+					break;
+				}
+			}
+		}
+
+		const SIZE_T SlotsSize = sizeof(FSlot) * NewNumSlots;
+		const SIZE_T DisplacementsSize = sizeof(uint32) * NewNumBuckets;
+		Memory = FMemory::Malloc(SlotsSize + DisplacementsSize, alignof(FSlot));
+		Slots = static_cast<FSlot*>(Memory);
+		Displacements = reinterpret_cast<uint32*>(static_cast<uint8*>(Memory) + SlotsSize);
+		NumSlots = NewNumSlots;
+		NumBuckets = NewNumBuckets;
+		NumBindings = Entries.Num();
+
+		for (uint32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+		{
+			new(&Slots[SlotIndex]) FSlot();
+		}
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			Slots[EntrySlots[EntryIndex]] = *Entries[EntryIndex];
+		}
+		FMemory::Memcpy(Displacements, NewDisplacements.GetData(), DisplacementsSize);
+	}
+
+	void FFrozenBindingTable::Release()
+	{
+		if (!Memory)
+			return;
+
+		for (uint32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+		{
+			Slots[SlotIndex].~FSlot();
+		}
+		FMemory::Free(Memory);
+		Memory = nullptr;
+		Slots = nullptr;
+		Displacements = nullptr;
+		NumSlots = 0;
+		NumBuckets = 0;
+		NumBindings = 0;
+	}
+}
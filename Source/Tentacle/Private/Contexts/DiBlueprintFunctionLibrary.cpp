@@ -9,6 +9,59 @@
 #include "Contexts/AutoInjectableInterface.h"
 #include "Contexts/DiContextInterface.h"
 
+namespace DI::Private
+{
+	/** Write the result of a struct resolve to both outputs of its custom thunk. */
+	static void FinishStructResolve(bool bResult, EStructUtilsResult& Result, void* const ReturnValue)
+	{
+		Result = bResult ? EStructUtilsResult::Valid : EStructUtilsResult::NotValid;
+		*static_cast<bool*>(ReturnValue) = bResult;
+	}
+
+	/** Abort the execution of the calling blueprint and report the struct as not valid. */
+	static void AbortStructResolve(FFrame& Stack, const FText& Description, EStructUtilsResult& Result, void* const ReturnValue)
+	{
+		FBlueprintExceptionInfo ExceptionInfo(EBlueprintExceptionType::AbortExecution, Description);
+		FBlueprintCoreDelegates::ThrowScriptException(Stack.Object, Stack, ExceptionInfo);
+		FinishStructResolve(false, Result, ReturnValue);
+	}
+
+	/** Find a member by its name or, for members of user defined structs which have generated names, by the name that is displayed in the editor. */
+	static const FProperty* FindStructMember(const UScriptStruct* StructType, FName MemberName)
+	{
+		if (const FProperty* MemberProperty = StructType->FindPropertyByName(MemberName))
+			return MemberProperty;
+
+		const FString MemberNameString = MemberName.ToString();
+		for (TFieldIterator<FProperty> PropertyIt(StructType); PropertyIt; ++PropertyIt)
+		{
+			if (PropertyIt->GetAuthoredName() == MemberNameString)
+				return *PropertyIt;
+		}
+		return nullptr;
+	}
+
+	/** Copy a single member of bound struct data to a value of the same type. */
+	static bool TryCopyStructMember(const DI::FUStructBindingView& StructView, const UScriptStruct* StructType, FName MemberName, const FProperty& ValueProp, void* ValuePtr)
+	{
+		const FProperty* MemberProperty = FindStructMember(StructType, MemberName);
+		if (!MemberProperty)
+		{
+			UE_LOG(LogDependencyInjection, Error, TEXT("%s has no member %s"), *StructType->GetName(), *MemberName.ToString());
+			return false;
+		}
+		if (!MemberProperty->SameType(&ValueProp))
+		{
+			UE_LOG(LogDependencyInjection, Error, TEXT("Member %s of %s is a %s and can not be written to a %s"),
+				*MemberName.ToString(), *StructType->GetName(), *MemberProperty->GetCPPType(), *ValueProp.GetCPPType());
+			return false;
+		}
+
+		MemberProperty->CopyCompleteValue(ValuePtr, MemberProperty->ContainerPtrToValuePtr<void>(StructView.GetMemory()));
+		return true;
+	}
+}
+
 
 TScriptInterface<IDiContextInterface> UDiBlueprintFunctionLibrary::FindDiContextForObject(UObject* ContextObject)
 {
@@ -66,6 +119,18 @@ bool UDiBlueprintFunctionLibrary::TryResolveStructCopy(
 	return false;
 }
 
+bool UDiBlueprintFunctionLibrary::TryResolveStructMember(
+	TScriptInterface<IDiContextInterface> DiContextInterface,
+	UScriptStruct* StructType,
+	FName BindingName,
+	FName MemberName,
+	int32& OutValue,
+	EStructUtilsResult& Result)
+{
+	checkNoEntry();
+	return false;
+}
+
 void UDiBlueprintFunctionLibrary::BindObject(
 	TScriptInterface<IDiContextInterface> DiContextInterface,
 	UObject* Object,
@@ -143,22 +208,24 @@ void UDiBlueprintFunctionLibrary::BindObjectAsType(
 	}
 
 	DI::FChainedDiContainer& DiContainer = DiContextInterface->GetDiContainer();
-	TSharedPtr<DI::FBinding> Binding;
+	TRefCountPtr<DI::FBinding> Binding;
 	if (ObjectBindingType->HasAnyClassFlags(CLASS_Interface))
 	{
-		Binding = MakeShared<DI::FUInterfaceBinding>(
+		Binding = DI::MakeBinding<DI::FUInterfaceBinding>(
+			DiContainer.GetBindingArena(),
 			DI::FBindingId(DI::FTypeId(ObjectBindingType), BindingName),
 			FScriptInterface(Object, Object->GetNativeInterfaceAddress(ObjectBindingType))
 		);
 	}
 	else
 	{
-		Binding = MakeShared<DI::TUObjectBinding<UObject>>(
+		Binding = DI::MakeBinding<DI::TUObjectBinding<UObject>>(
+			DiContainer.GetBindingArena(),
 			DI::FBindingId(DI::FTypeId(ObjectBindingType), BindingName),
 			Object
 		);
 	}
-	DI::EBindResult Result = DiContainer.BindSpecific(Binding.ToSharedRef(), DI::EBindConflictBehavior::BlueprintException);
+	DI::EBindResult Result = DiContainer.BindSpecific(Binding, DI::EBindConflictBehavior::BlueprintException);
 }
 
 DEFINE_FUNCTION(UDiBlueprintFunctionLibrary::execTryResolveStruct)
@@ -180,30 +247,18 @@ DEFINE_FUNCTION(UDiBlueprintFunctionLibrary::execTryResolveStruct)
 
 	if (!ValueProp || !ValuePtr || !DiContextInterface)
 	{
-		FBlueprintExceptionInfo ExceptionInfo(
-			EBlueprintExceptionType::AbortExecution,
-			INVTEXT("Failed to resolve the Value for Struct")
-		);
-
-		FBlueprintCoreDelegates::ThrowScriptException(Stack.Object, Stack, ExceptionInfo);
-
-		P_NATIVE_BEGIN;
-			Result = EStructUtilsResult::NotValid;
-			(*static_cast<bool*>(RESULT_PARAM)) = false;
-		P_NATIVE_END;
-	}
-	else
-	{
-		P_NATIVE_BEGIN;
-			bool bResult = DiContextInterface->DiResolve().TryGetUStruct(
-				ValueProp->Struct,
-				ValuePtr,
-				BindingName
-			);
-			Result = bResult ? EStructUtilsResult::Valid : EStructUtilsResult::NotValid;
-			(*static_cast<bool*>(RESULT_PARAM)) = bResult;
-		P_NATIVE_END;
+		DI::Private::AbortStructResolve(Stack, INVTEXT("Failed to resolve the Value for Struct"), Result, RESULT_PARAM);
+		return;
 	}
+
+	P_NATIVE_BEGIN;
+		const bool bResult = DiContextInterface->DiResolve().TryGetUStruct(
+			ValueProp->Struct,
+			ValuePtr,
+			BindingName
+		);
+		DI::Private::FinishStructResolve(bResult, Result, RESULT_PARAM);
+	P_NATIVE_END;
 }
 
 DEFINE_FUNCTION(UDiBlueprintFunctionLibrary::execTryResolveStructCopy)
@@ -226,32 +281,52 @@ DEFINE_FUNCTION(UDiBlueprintFunctionLibrary::execTryResolveStructCopy)
 
 	if (!ValueProp || !ValuePtr || !DiContextInterface || !StructType)
 	{
-		FBlueprintExceptionInfo ExceptionInfo(
-			EBlueprintExceptionType::AbortExecution,
-			INVTEXT("Failed to resolve the Value for Struct")
-		);
+		DI::Private::AbortStructResolve(Stack, INVTEXT("Failed to resolve the Value for Struct"), Result, RESULT_PARAM);
+		return;
+	}
 
-		FBlueprintCoreDelegates::ThrowScriptException(Stack.Object, Stack, ExceptionInfo);
+	P_NATIVE_BEGIN;
+		const bool bResult = DiContextInterface->GetDiContainer()
+		                                       .Resolve()
+		                                       .TryGetUStruct(
+			                                       StructType,
+			                                       ValuePtr,
+			                                       BindingName
+		                                       );
+		DI::Private::FinishStructResolve(bResult, Result, RESULT_PARAM);
+	P_NATIVE_END;
+}
 
-		P_NATIVE_BEGIN;
-			Result = EStructUtilsResult::NotValid;
-			(*static_cast<bool*>(RESULT_PARAM)) = false;
-		P_NATIVE_END;
-	}
-	else
+DEFINE_FUNCTION(UDiBlueprintFunctionLibrary::execTryResolveStructMember)
+{
+	P_GET_TINTERFACE(IDiContextInterface, DiContextInterface);
+	P_GET_OBJECTPTR(UScriptStruct, StructType);
+	P_GET_PROPERTY(FNameProperty, BindingName);
+	P_GET_PROPERTY(FNameProperty, MemberName);
+
+	// Read wildcard Value input.
+	Stack.MostRecentPropertyAddress = nullptr;
+	Stack.MostRecentPropertyContainer = nullptr;
+	Stack.StepCompiledIn<FProperty>(nullptr);
+
+	const FProperty* ValueProp = Stack.MostRecentProperty;
+	void* ValuePtr = Stack.MostRecentPropertyAddress;
+
+	P_GET_ENUM_REF(EStructUtilsResult, Result);
+
+	P_FINISH;
+
+	if (!ValueProp || !ValuePtr || !DiContextInterface || !StructType)
 	{
-		P_NATIVE_BEGIN;
-			bool bResult = DiContextInterface->GetDiContainer()
-			                                 .Resolve()
-			                                 .TryGetUStruct(
-				                                 StructType,
-				                                 ValuePtr,
-				                                 BindingName
-			                                 );
-			Result = bResult ? EStructUtilsResult::Valid : EStructUtilsResult::NotValid;
-			(*static_cast<bool*>(RESULT_PARAM)) = bResult;
-		P_NATIVE_END;
+		DI::Private::AbortStructResolve(Stack, INVTEXT("Failed to resolve the Value for Struct Member"), Result, RESULT_PARAM);
+		return;
 	}
+
+	P_NATIVE_BEGIN;
+		const DI::FUStructBindingView StructView = DiContextInterface->GetDiContainer().Resolve().TryGetUStructView(StructType, BindingName);
+		const bool bResult = StructView.IsValid() && DI::Private::TryCopyStructMember(StructView, StructType, MemberName, *ValueProp, ValuePtr);
+		DI::Private::FinishStructResolve(bResult, Result, RESULT_PARAM);
+	P_NATIVE_END;
 }
 
 DEFINE_FUNCTION(UDiBlueprintFunctionLibrary::execTryResolveInterface)
@@ -280,12 +355,12 @@ DEFINE_FUNCTION(UDiBlueprintFunctionLibrary::execTryResolveInterface)
 		FName BindingName = BindingNameProperty;
 		P_NATIVE_BEGIN;
 			DI::FBindingId BindingId(DI::FTypeId(InterfaceType.Get()), BindingName);
-			TSharedPtr<DI::FBinding> Binding = DiContextInterface->GetDiContainer().FindBinding(BindingId);
+			const DI::FBinding* Binding = DiContextInterface->GetDiContainer().FindBindingRaw(BindingId.GetKey());
 			if (!Binding)
 			{
 				UE_LOG(LogDependencyInjection, Error, TEXT("Failed to resolve Interface Binding %s"), *BindingId.ToString());
 			}
-			TSharedPtr<DI::FUInterfaceBinding> InterfaceBinding = StaticCastSharedPtr<DI::FUInterfaceBinding>(Binding);
+			const DI::FUInterfaceBinding* InterfaceBinding = Binding ? &static_cast<const DI::FUInterfaceBinding&>(Binding->GetInstanceBinding()) : nullptr;
 			(*static_cast<UObject**>(RESULT_PARAM)) = InterfaceBinding ? InterfaceBinding->Resolve().GetObject() : nullptr;
 		P_NATIVE_END;
 	}
@@ -319,8 +394,9 @@ DEFINE_FUNCTION(UDiBlueprintFunctionLibrary::execBindStruct)
 	{
 		P_NATIVE_BEGIN;
 			{
-				TSharedRef<DI::FRawDataBinding> StructDataBinding = MakeShared<DI::FUStructBinding>(ValueProp->Struct, BindingName, ValuePtr);
-				DiContextInterface->GetDiContainer().BindSpecific(StructDataBinding, DI::EBindConflictBehavior::BlueprintException);
+				DI::FChainedDiContainer& DiContainer = DiContextInterface->GetDiContainer();
+				TRefCountPtr<DI::FBinding> StructDataBinding(DI::MakeBinding<DI::FUStructBinding>(DiContainer.GetBindingArena(), ValueProp->Struct, BindingName, ValuePtr));
+				DiContainer.BindSpecific(StructDataBinding, DI::EBindConflictBehavior::BlueprintException);
 			}
 		P_NATIVE_END;
 	}
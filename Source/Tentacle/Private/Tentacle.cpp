@@ -2,6 +2,8 @@
 
 #include "Tentacle.h"
 
+#include "Container/DiContainerBase.h"
+
 #define LOCTEXT_NAMESPACE "FTentacleModule"
 
 DEFINE_LOG_CATEGORY(LogDependencyInjection);
@@ -9,12 +11,14 @@ DEFINE_LOG_CATEGORY(LogDependencyInjection);
 void FTentacleModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	DI::FDiContainerBase::StartGarbageCollectionSweeps();
 }
 
 void FTentacleModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	DI::FDiContainerBase::StopGarbageCollectionSweeps();
 }
 
 #undef LOCTEXT_NAMESPACE
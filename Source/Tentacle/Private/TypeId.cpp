@@ -3,8 +3,84 @@
 
 #include "TypeId.h"
 
+#include "Misc/ScopeRWLock.h"
+#include "UObject/ObjectKey.h"
+
 const DI::FTypeId DI::FTypeId::InvalidId = FTypeId();
 
+namespace DI::Private
+{
+	struct FTypeIndexRegistry
+	{
+		FRWLock Lock;
+		/** Native type names are string literals that live as long as the process. */
+		TMap<const void*, uint32> NativeTypeIndices;
+		/** Keyed by object instead of address, so a type that is allocated where a destroyed one lived does not inherit its index. */
+		TMap<FObjectKey, uint32> UTypeIndices;
+		/** Index 0 is reserved for invalid type IDs. */
+		uint32 NextTypeIndex = 1;
+	};
+
+	/** Most recent lookups of a thread, so reflection paths that resolve the same few types over and over skip the lock. */
+	struct FCachedTypeIndex
+	{
+		FObjectKey TypeKey;
+		uint32 TypeIndex = 0;
+	};
+	constexpr int32 NumCachedTypeIndices = 16;
+	static thread_local FCachedTypeIndex GCachedTypeIndices[NumCachedTypeIndices];
+
+	// Function local static so type IDs that are created during static initialization of other modules can use it.
+	static FTypeIndexRegistry& GetTypeIndexRegistry()
+	{
+		static FTypeIndexRegistry Registry;
+		return Registry;
+	}
+
+	template <class TKey>
+	static uint32 FindOrAddTypeIndex(TMap<TKey, uint32> FTypeIndexRegistry::* TypeIndices, const TKey& Key)
+	{
+		FTypeIndexRegistry& Registry = GetTypeIndexRegistry();
+		{
+			FReadScopeLock ReadLock(Registry.Lock);
+			if (const uint32* TypeIndex = (Registry.*TypeIndices).Find(Key))
+			{
+				return *TypeIndex;
+			}
+		}
+
+		FWriteScopeLock WriteLock(Registry.Lock);
+		if (const uint32* TypeIndex = (Registry.*TypeIndices).Find(Key))
+		{
+			return *TypeIndex;
+		}
+		return (Registry.*TypeIndices).Add(Key, Registry.NextTypeIndex++);
+	}
+
+	uint32 RegisterTypeIndex(const TCHAR* NativeTypeName)
+	{
+		if (!NativeTypeName)
+			return 0;
+
+		return FindOrAddTypeIndex<const void*>(&FTypeIndexRegistry::NativeTypeIndices, NativeTypeName);
+	}
+
+	uint32 RegisterTypeIndex(const UStruct* Type)
+	{
+		if (!Type)
+			return 0;
+
+		const FObjectKey TypeKey(Type);
+		FCachedTypeIndex& CachedTypeIndex = GCachedTypeIndices[GetTypeHash(TypeKey) % NumCachedTypeIndices];
+		if (CachedTypeIndex.TypeKey == TypeKey)
+			return CachedTypeIndex.TypeIndex;
+
+		const uint32 TypeIndex = FindOrAddTypeIndex(&FTypeIndexRegistry::UTypeIndices, TypeKey);
+		CachedTypeIndex = {TypeKey, TypeIndex};
+		return TypeIndex;
+	}
+}
+
 FName DI::FTypeId::GetName() const
 {
 	switch (Type)
@@ -12,6 +12,9 @@ namespace DI
 		Bound,
 
 		// The binding is in conflict with an already created binding and has been rejected.
-		Conflict
+		Conflict,
+
+		// The container is frozen and rejects new bindings.
+		Frozen
 	};
 }
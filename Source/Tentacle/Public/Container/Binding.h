@@ -1,17 +1,22 @@
 ﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
 
 #pragma once
+#include "BindingArena.h"
 #include "BindingId.h"
 #include "TypeId.h"
 #include "StructUtils/InstancedStruct.h"
+#include "StructUtils/StructView.h"
+#include "Templates/RefCounting.h"
+#include <atomic>
 
 namespace DI
 {
 	/**
 	 * Common parent for all bindings.
 	 * This binding has no resolve-capabilities of its own but can do tracking for the Garbage Collector.
+	 * Bindings are reference counted intrusively and should be created with MakeBinding so they live in the arena of their container.
 	 */
-	class FBinding
+	class FBinding : public FRefCountBase
 	{
 	public:
 		FBinding(FBindingId BindingId)
@@ -19,7 +24,27 @@ namespace DI
 		{
 		}
 
-		virtual ~FBinding() = default;
+		virtual ~FBinding() override = default;
+
+		static void* operator new(SIZE_T Size)
+		{
+			return FBindingArena::Allocate(Size, nullptr);
+		}
+
+		static void* operator new(SIZE_T Size, FBindingArena* Arena)
+		{
+			return FBindingArena::Allocate(Size, Arena);
+		}
+
+		static void operator delete(void* Memory)
+		{
+			FBindingArena::Free(Memory);
+		}
+
+		static void operator delete(void* Memory, FBindingArena* Arena)
+		{
+			FBindingArena::Free(Memory);
+		}
 
 		FORCEINLINE FBindingId GetId() const
 		{
@@ -36,6 +61,58 @@ namespace DI
 			return true;
 		}
 
+		/**
+		 * @return true if IsValid can change from true to false after the binding has been bound, e.g. because the bound UObject has been destroyed.
+		 * Containers remove such bindings after garbage collection once they have become invalid.
+		 */
+		FORCEINLINE bool CanExpire() const
+		{
+			return bCanExpire;
+		}
+
+		/**
+		 * Get the slot of the single UObject that this binding references, if it has one.
+		 * Containers report these slots in bulk instead of calling AddReferencedObjects on every binding.
+		 */
+		FORCEINLINE TObjectPtr<UObject>* GetObjectReferenceSlot() const
+		{
+			return ObjectReferenceSlot;
+		}
+
+		/** @return true if the references of this binding can only be reported by calling AddReferencedObjects. */
+		FORCEINLINE bool HasComplexReferences() const
+		{
+			return bHasComplexReferences;
+		}
+
+		/**
+		 * Get the binding that holds the instance.
+		 * This is the binding itself, except for lazy bindings which construct their instance on first use.
+		 */
+		FORCEINLINE const FBinding& GetInstanceBinding() const
+		{
+			return bIsLazy ? GetLazyInstanceBinding() : *this;
+		}
+
+	protected:
+		/** Construct the instance of a lazy binding if that has not happened yet. */
+		virtual const FBinding& GetLazyInstanceBinding() const
+		{
+			return *this;
+		}
+
+		/** Lazy bindings set this so resolving only pays for a virtual call if the binding is actually lazy. */
+		bool bIsLazy = false;
+
+		/** Set by bindings whose validity depends on a UObject. */
+		bool bCanExpire = false;
+
+		/** Cleared by bindings that report all of their references through ObjectReferenceSlot or have none. */
+		bool bHasComplexReferences = true;
+
+		/** Points to the only UObject reference of the binding. Has to stay valid for the lifetime of the binding. */
+		TObjectPtr<UObject>* ObjectReferenceSlot = nullptr;
+
 	private:
 		FBindingId Id;
 	};
@@ -57,6 +134,9 @@ namespace DI
 			: Super(BindingId), UObjectDependency(MoveTemp(InObject))
 		{
 			static_assert(TIsDerivedFrom<T, UObject>::IsDerived);
+			bCanExpire = true;
+			bHasComplexReferences = false;
+			ObjectReferenceSlot = reinterpret_cast<TObjectPtr<UObject>*>(&UObjectDependency);
 			checkf(
 				InObject.GetClass()->IsChildOf(static_cast<UClass*>(BindingId.GetBoundTypeId().TryGetUType())),
 				TEXT("%s is not derived from %s"),
@@ -94,6 +174,9 @@ namespace DI
 		FUInterfaceBinding(FBindingId BindingId, const FScriptInterface& InInterface)
 			: Super(BindingId), InterfaceDependency(InInterface)
 		{
+			bCanExpire = true;
+			bHasComplexReferences = false;
+			ObjectReferenceSlot = &InterfaceDependency.GetObjectRef();
 		}
 
 		virtual bool IsValid() const override
@@ -143,6 +226,7 @@ namespace DI
 		TSharedNativeDependencyBinding(FBindingId BindingId, TSharedRef<T> InSharedInstance)
 			: Super(BindingId), SharedNativeDependency(InSharedInstance)
 		{
+			bHasComplexReferences = false;
 		}
 
 		TSharedRef<T> Resolve() const
@@ -164,49 +248,149 @@ namespace DI
 		{
 		}
 
-		virtual void CopyRawData(void* OutData, int32 SizeOfOutData) = 0;
+		virtual void CopyRawData(void* OutData, int32 SizeOfOutData) const = 0;
 	};
 
 
 	/**
 	 * Binding that holds UStruct data.
 	 * Native types have to be referenced through shared pointers.
+	 * Small structs are stored inline in the binding, bigger ones get a separate allocation.
 	 */
 	class FUStructBinding : public FRawDataBinding
 	{
 	public:
 		using Super = FRawDataBinding;
 
-		FUStructBinding(UScriptStruct* StructType, FName BindingName, const uint8* StructMemoryToCopy)
-			: Super(FBindingId(FTypeId(StructType), BindingName))
+		/** Structs up to this size are stored inline in the binding. */
+		static constexpr int32 InlineStorageSize = 64;
+		static constexpr int32 InlineStorageAlignment = 16;
+
+		/** @param BindingId - ID of the binding. Has to be of InStructType, which callers know statically, so no type ID has to be looked up here. */
+		FUStructBinding(UScriptStruct* InStructType, FBindingId BindingId, const uint8* StructMemoryToCopy)
+			: Super(MoveTemp(BindingId))
+			, StructType(InStructType)
+			, bIsPlainOldData((InStructType->StructFlags & STRUCT_IsPlainOldData) != 0)
+		{
+			const int32 StructureSize = InStructType->GetStructureSize();
+			StructMemory = StructureSize <= InlineStorageSize && InStructType->GetMinAlignment() <= InlineStorageAlignment
+				               ? InlineStorage
+				               : static_cast<uint8*>(FMemory::Malloc(StructureSize, InStructType->GetMinAlignment()));
+
+			if (bIsPlainOldData)
+			{
+				FMemory::Memcpy(StructMemory, StructMemoryToCopy, StructureSize);
+			}
+			else
+			{
+				InStructType->InitializeStruct(StructMemory);
+				InStructType->CopyScriptStruct(StructMemory, StructMemoryToCopy);
+			}
+
+			// Native structs without object properties keep nothing alive, their type is never collected.
+			const bool bHasObjectReferences = InStructType->RefLink != nullptr || (InStructType->StructFlags & STRUCT_AddStructReferencedObjects) != 0;
+			bHasComplexReferences = bHasObjectReferences || !InStructType->IsNative();
+		}
+
+		virtual ~FUStructBinding() override
+		{
+			if (!bIsPlainOldData)
+			{
+				StructType->DestroyStruct(StructMemory);
+			}
+			if (StructMemory != InlineStorage)
+			{
+				FMemory::Free(StructMemory);
+			}
+		}
+
+		const UScriptStruct* GetStruct() const
 		{
-			StructData.InitializeAs(StructType, StructMemoryToCopy);
+			return StructType;
 		}
 
-		const UScriptStruct* GetStruct()
+		/** @return the bound struct data. Valid for as long as this binding is alive. */
+		const uint8* GetStructMemory() const
 		{
-			return StructData.GetScriptStruct();
+			return StructMemory;
 		}
 
 		virtual void AddReferencedObjects(FReferenceCollector& Collector) override
 		{
 			Super::AddReferencedObjects(Collector);
-			StructData.AddStructReferencedObjects(Collector);
+			Collector.AddReferencedObject(StructType);
+			// Plain old data can still hold raw UObject pointers, so even those have to be reported.
+			Collector.AddPropertyReferencesWithStructARO(StructType, StructMemory);
 		}
 
-		virtual void CopyRawData(void* OutData, int32 OutDataSize) override
+		virtual void CopyRawData(void* OutData, int32 OutDataSize) const override
 		{
-			const UScriptStruct* StructClass = GetStruct();
-			check(StructClass->GetStructureSize() <= OutDataSize);
-			StructClass->CopyScriptStruct(OutData, StructData.GetMemory(), 1);
+			check(StructType->GetStructureSize() <= OutDataSize);
+			if (bIsPlainOldData)
+			{
+				FMemory::Memcpy(OutData, StructMemory, StructType->GetStructureSize());
+			}
+			else
+			{
+				StructType->CopyScriptStruct(OutData, StructMemory, 1);
+			}
 		};
 
 	protected:
-		/**
-		 * Manages the inner struct data.
-		 * We could inline the data to avoid the secondary allocation, but we would basically reimplement FInstancedStruct.
-		 */
-		FInstancedStruct StructData;
+		TObjectPtr<const UScriptStruct> StructType;
+
+		/** Points either into InlineStorage or to a separate allocation for big structs. */
+		uint8* StructMemory = nullptr;
+
+		/** Plain old data structs neither need construction nor destruction and can be copied with a memcpy. */
+		bool bIsPlainOldData = false;
+
+		alignas(InlineStorageAlignment) uint8 InlineStorage[InlineStorageSize];
+	};
+
+	/**
+	 * Read-only view of the struct data of a struct binding.
+	 * Keeps the binding alive, so the data stays valid for as long as the view exists, even if the binding is replaced in the meantime.
+	 */
+	class FUStructBindingView
+	{
+	public:
+		FUStructBindingView() = default;
+
+		explicit FUStructBindingView(TRefCountPtr<FUStructBinding> InBinding)
+			: Binding(MoveTemp(InBinding))
+		{
+		}
+
+		bool IsValid() const
+		{
+			return Binding.IsValid();
+		}
+
+		const UScriptStruct* GetStruct() const
+		{
+			return Binding ? Binding->GetStruct() : nullptr;
+		}
+
+		const uint8* GetMemory() const
+		{
+			return Binding ? Binding->GetStructMemory() : nullptr;
+		}
+
+		FConstStructView Get() const
+		{
+			return FConstStructView(GetStruct(), GetMemory());
+		}
+
+		template <class T>
+		const T& Get() const
+		{
+			check(GetStruct() && GetStruct()->IsChildOf(T::StaticStruct()));
+			return *reinterpret_cast<const T*>(GetMemory());
+		}
+
+	private:
+		TRefCountPtr<FUStructBinding> Binding;
 	};
 
 	/**
@@ -220,18 +404,157 @@ namespace DI
 		using Super = FUStructBinding;
 
 		TTypedStructBinding(FBindingId BindingId, const T& InInstance)
-			: Super(T::StaticStruct(), BindingId.GetBindingName(), reinterpret_cast<const uint8*>(&InInstance))
+			: Super(T::StaticStruct(), BindingId, reinterpret_cast<const uint8*>(&InInstance))
 		{
 			checkf(T::StaticStruct() == BindingId.GetBoundTypeId().TryGetUType(), TEXT("Inherited struct types are not supported at this moment"));
 		}
 
 		const T& Resolve() const
 		{
-			return StructData.Get<T>();
+			return *reinterpret_cast<const T*>(StructMemory);
 		}
 	};
 
 
+	/**
+	 * Create a binding in the given arena.
+	 * @param Arena - the arena of the container the binding will be bound in. Allocates from the heap if null.
+	 */
+	template <class TBinding, class... TArgs>
+	TRefCountPtr<TBinding> MakeBinding(FBindingArena* Arena, TArgs&&... Args)
+	{
+		static_assert(TIsDerivedFrom<TBinding, FBinding>::IsDerived);
+		return TRefCountPtr<TBinding>(new(Arena) TBinding(Forward<TArgs>(Args)...));
+	}
+
+	/**
+	 * Common parent for bindings of a set of instances.
+	 * Binding a set where one is already bound appends to the existing set instead of being a conflict.
+	 */
+	class FBindingSet : public FBinding
+	{
+	public:
+		using Super = FBinding;
+
+		FBindingSet(FBindingId BindingId)
+			: Super(MoveTemp(BindingId))
+		{
+			check(GetId().IsSet());
+		}
+
+		/** Append all instances of another set of the same type. */
+		virtual void Append(const FBindingSet& Other) = 0;
+
+		/** Create a copy of this set in the given arena. Used by containers that can not modify bound sets in place. */
+		virtual TRefCountPtr<FBindingSet> Clone(FBindingArena* Arena) const = 0;
+
+		virtual int32 Num() const = 0;
+	};
+
+	/** How instances of T are stored in a set. */
+	template <class T>
+	using TBindingSetElement = DI::TBindingInstValue<T>;
+
+	/**
+	 * Binding of a set of instances of T.
+	 * The instances are stored contiguously in the order they have been added.
+	 */
+	template <class T>
+	class TBindingSet final : public FBindingSet
+	{
+	public:
+		using Super = FBindingSet;
+		using ElementType = TBindingSetElement<T>;
+
+		TBindingSet(FBindingId BindingId, TArray<ElementType> InElements)
+			: Super(MoveTemp(BindingId)), Elements(MoveTemp(InElements))
+		{
+		}
+
+		TBindingSet(FBindingId BindingId, TBindingInstRef<T> Instance)
+			: Super(MoveTemp(BindingId))
+		{
+			Elements.Add(Instance);
+		}
+
+		virtual void Append(const FBindingSet& Other) override
+		{
+			check(Other.GetId() == GetId());
+			Elements.Append(static_cast<const TBindingSet&>(Other).Elements);
+		}
+
+		virtual TRefCountPtr<FBindingSet> Clone(FBindingArena* Arena) const override
+		{
+			return TRefCountPtr<FBindingSet>(new(Arena) TBindingSet(GetId(), Elements));
+		}
+
+		virtual int32 Num() const override
+		{
+			return Elements.Num();
+		}
+
+		/** Call the visitor with every instance that is still valid. Must not add to this set while iterating. */
+		template <class TVisitor>
+		void ForEach(TVisitor&& Visitor) const
+		{
+			for (const ElementType& Element : Elements)
+			{
+				if (IsElementValid(Element))
+				{
+					Visitor(Element);
+				}
+			}
+		}
+
+		virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+		{
+			Super::AddReferencedObjects(Collector);
+			if constexpr (DI::THasUClass<T>::Value)
+			{
+				if constexpr (TIsIInterface<T>::Value)
+				{
+					for (ElementType& Element : Elements)
+					{
+						Element.AddReferencedObjects(Collector);
+					}
+				}
+				else
+				{
+					Collector.AddReferencedObjects(Elements);
+				}
+			}
+			else if constexpr (DI::HasUStruct<T>())
+			{
+				for (ElementType& Element : Elements)
+				{
+					Collector.AddPropertyReferencesWithStructARO(T::StaticStruct(), &Element);
+				}
+			}
+		}
+
+	private:
+		static bool IsElementValid(const ElementType& Element)
+		{
+			if constexpr (DI::THasUClass<T>::Value)
+			{
+				if constexpr (TIsIInterface<T>::Value)
+				{
+					return ::IsValid(Element.GetObject());
+				}
+				else
+				{
+					return ::IsValid(Element);
+				}
+			}
+			else
+			{
+				return true;
+			}
+		}
+
+		TArray<ElementType> Elements;
+	};
+
 	template <class T>
 	using TBindingType = DI::TBindingInstanceTypeSwitch<
 		T,
@@ -239,4 +562,156 @@ namespace DI
 		TUInterfaceDependencyBinding<T>, // IInterface
 		TTypedStructBinding<T>, // UStruct
 		TSharedNativeDependencyBinding<T>>; // Native
+
+	/**
+	 * Resolve the instance of a binding that has been bound for T.
+	 * UObjects and interfaces are read from the object reference slot and cast to T instead of treating the binding as a binding of T,
+	 * because polymorphic bindings hold the instance in a binding of UObject or of the interface base that has been bound for all of its ancestors.
+	 */
+	template <class T>
+	TBindingInstRef<T> ResolveBinding(const FBinding& Binding)
+	{
+		const FBinding& InstanceBinding = Binding.GetInstanceBinding();
+		if constexpr (THasUClass<std::decay_t<T>>::Value)
+		{
+			UObject* Object = InstanceBinding.GetObjectReferenceSlot()->Get();
+			check(Object);
+			if constexpr (TIsIInterface<std::decay_t<T>>::Value)
+			{
+				return TScriptInterface<T>(Object);
+			}
+			else
+			{
+				// Bindings check that the instance is derived from the bound class when they are created.
+				return TObjectPtr<T>(static_cast<T*>(Object));
+			}
+		}
+		else
+		{
+			return static_cast<const TBindingType<T>&>(InstanceBinding).Resolve();
+		}
+	}
+
+	namespace Private
+	{
+		/**
+		 * Marks the lazy binding whose factory the calling thread is running.
+		 * Fails with a fatal error if the binding is already being constructed on this thread, i.e. if the factory resolves its own binding.
+		 */
+		class TENTACLE_API FLazyConstructionScope
+		{
+		public:
+			explicit FLazyConstructionScope(const FBinding& InBinding);
+			~FLazyConstructionScope();
+
+			FLazyConstructionScope(const FLazyConstructionScope&) = delete;
+			FLazyConstructionScope& operator=(const FLazyConstructionScope&) = delete;
+
+		private:
+			const FBinding& Binding;
+			/** Scope of the lazy binding whose factory resolved this one, if any. */
+			FLazyConstructionScope* Outer;
+		};
+	}
+
+	/**
+	 * Binding that constructs its instance with a factory the first time it is resolved.
+	 * The factory runs outside of any lock, so it may resolve other lazy bindings freely. If the binding is resolved from multiple threads
+	 * at the same time, each of them may run the factory, but only the first constructed instance is published and everybody resolves that one.
+	 * Waiters are handed the instance binding, so a lazy binding that is bound while somebody waits for it is constructed right away.
+	 * The constructed instance is held in a regular binding of TBindingType<T>, which GetInstanceBinding returns.
+	 * @note UObjects captured by the factory are not reported to the garbage collector.
+	 */
+	template <class T>
+	class TLazyBinding final : public FBinding
+	{
+	public:
+		using Super = FBinding;
+		using FFactory = TFunction<TBindingInstValue<T>()>;
+
+		TLazyBinding(FBindingId BindingId, FFactory InFactory)
+			: Super(MoveTemp(BindingId)), Factory(MoveTemp(InFactory))
+		{
+			check(Factory);
+			bIsLazy = true;
+			bCanExpire = DI::THasUClass<T>::Value;
+		}
+
+		virtual ~TLazyBinding() override
+		{
+			if (FBinding* Constructed = ConstructedBindingPtr.load(std::memory_order_acquire))
+			{
+				Constructed->Release();
+			}
+		}
+
+		/** @return true once the instance has been constructed. */
+		bool IsConstructed() const
+		{
+			return ConstructedBindingPtr.load(std::memory_order_acquire) != nullptr;
+		}
+
+		virtual bool IsValid() const override
+		{
+			const FBinding* Constructed = ConstructedBindingPtr.load(std::memory_order_acquire);
+			return !Constructed || Constructed->IsValid();
+		}
+
+		virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+		{
+			Super::AddReferencedObjects(Collector);
+			if (FBinding* Constructed = ConstructedBindingPtr.load(std::memory_order_acquire))
+			{
+				Constructed->AddReferencedObjects(Collector);
+			}
+		}
+
+	protected:
+		virtual const FBinding& GetLazyInstanceBinding() const override
+		{
+			if (const FBinding* Constructed = ConstructedBindingPtr.load(std::memory_order_acquire))
+			{
+				return *Constructed;
+			}
+
+			// Copy the factory so the winner can release it while others are still running their copy.
+			FFactory LocalFactory;
+			{
+				FScopeLock ScopeLock(&FactoryLock);
+				LocalFactory = Factory;
+			}
+			if (!LocalFactory)
+			{
+				// The factory is only released after the instance has been published.
+				return *ConstructedBindingPtr.load(std::memory_order_acquire);
+			}
+
+			FBinding* NewBinding;
+			{
+				Private::FLazyConstructionScope ConstructionScope(*this);
+				NewBinding = new TBindingType<T>(GetId(), LocalFactory());
+			}
+			NewBinding->AddRef();
+
+			FBinding* PublishedBinding = nullptr;
+			if (!ConstructedBindingPtr.compare_exchange_strong(PublishedBinding, NewBinding, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				// Another thread has been faster. Discard our instance so everybody resolves the same one.
+				NewBinding->Release();
+				return *PublishedBinding;
+			}
+
+			// The factory is not needed anymore, so let go of everything it captured.
+			FScopeLock ScopeLock(&FactoryLock);
+			Factory.Reset();
+			return *NewBinding;
+		}
+
+	private:
+		mutable FFactory Factory;
+		/** Only guards Factory itself. The factory is never run while holding it. */
+		mutable FCriticalSection FactoryLock;
+		/** The published instance binding. Holds a reference once set and never changes afterward. */
+		mutable std::atomic<FBinding*> ConstructedBindingPtr = nullptr;
+	};
 }
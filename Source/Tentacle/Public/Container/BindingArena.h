@@ -0,0 +1,76 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/RefCounting.h"
+
+namespace DI
+{
+	/**
+	 * Size class pool that the bindings of a single container are allocated from.
+	 *
+	 * Bindings are carved out of a few pages instead of getting a heap block each. The first page is small and every page after it
+	 * doubles in size up to MaxPageSize, so containers with only a handful of bindings stay cheap. Freed bindings go onto a free list
+	 * of their size class and are reused by the next binding of that size. The pages are released together once the arena
+	 * and all bindings allocated from it are gone, so a container that is torn down does not leave fragments behind.
+	 * Every allocation keeps the arena alive, so bindings may safely outlive the container that created them.
+	 */
+	class TENTACLE_API FBindingArena final : public FRefCountBase
+	{
+	public:
+		/** Bytes of the first page. Fits a few typical bindings. */
+		static constexpr SIZE_T FirstPageSize = 256;
+
+		/** Pages stop growing at this size, which fits a few dozen typical bindings. */
+		static constexpr SIZE_T MaxPageSize = 4096;
+
+		/** All allocations are aligned to this, which is also the size of the header in front of each allocation. */
+		static constexpr SIZE_T Alignment = 16;
+
+		FBindingArena() = default;
+		virtual ~FBindingArena() override;
+
+		/**
+		 * Allocate memory for a binding.
+		 * @param Size - size of the binding in bytes
+		 * @param Arena - the arena to allocate from. Falls back to the heap if this is null or the binding is too big for the pool.
+		 */
+		static void* Allocate(SIZE_T Size, FBindingArena* Arena);
+
+		/** Free memory that has been returned by Allocate. */
+		static void Free(void* Memory);
+
+		/** @return the number of bytes that are currently reserved in pages. */
+		SIZE_T GetReservedSize() const;
+
+	private:
+		struct alignas(Alignment) FAllocationHeader
+		{
+			/** Arena the allocation belongs to, or nullptr if it has been allocated from the heap. */
+			FBindingArena* Arena;
+			uint32 SizeClass;
+		};
+
+		static constexpr uint32 SizeClassGranularity = 16;
+		static constexpr uint32 NumSizeClasses = 16;
+		static constexpr SIZE_T MaxPooledSize = SizeClassGranularity * NumSizeClasses;
+		static_assert(FirstPageSize >= MaxPooledSize, "Every page has to fit a block of the biggest size class.");
+
+		struct FFreeBlock
+		{
+			FFreeBlock* Next;
+		};
+
+		void* AllocateBlock(uint32 SizeClass);
+		void FreeBlock(void* Block, uint32 SizeClass);
+
+		mutable FCriticalSection Lock;
+		FFreeBlock* FreeLists[NumSizeClasses] = {};
+		uint8* PageCursor = nullptr;
+		uint8* PageEnd = nullptr;
+		SIZE_T NextPageSize = FirstPageSize;
+		SIZE_T ReservedSize = 0;
+		TArray<void*> Pages;
+	};
+}
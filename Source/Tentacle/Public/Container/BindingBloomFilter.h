@@ -0,0 +1,64 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BindingKey.h"
+
+namespace DI
+{
+	/**
+	 * Fixed size bloom filter over binding keys.
+	 * Used by connected containers to answer "is this key bound anywhere in me or my ancestors?" without walking the chain.
+	 * Can only produce false positives, never false negatives, so keys are never removed from it.
+	 */
+	class FBindingBloomFilter
+	{
+	public:
+		static constexpr int32 NumWords = 16;
+		static constexpr uint32 NumBits = NumWords * 64;
+
+		FORCEINLINE void Add(const FBindingKey& Key)
+		{
+			SetBit(GetFirstBit(Key.GetHash()));
+			SetBit(GetSecondBit(Key.GetHash()));
+		}
+
+		/** @return false if the key has definitely never been added. */
+		FORCEINLINE bool MightContain(const FBindingKey& Key) const
+		{
+			return IsBitSet(GetFirstBit(Key.GetHash())) && IsBitSet(GetSecondBit(Key.GetHash()));
+		}
+
+		/** Add all keys of the other filter to this one. */
+		FORCEINLINE void Append(const FBindingBloomFilter& Other)
+		{
+			for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+			{
+				Words[WordIndex] |= Other.Words[WordIndex];
+			}
+		}
+
+		FORCEINLINE void Reset()
+		{
+			FMemory::Memzero(Words);
+		}
+
+	private:
+		// Binding key hashes are fully mixed, so two disjoint bit ranges of the hash are good enough as independent probes.
+		static FORCEINLINE uint32 GetFirstBit(uint32 Hash) { return Hash & (NumBits - 1); }
+		static FORCEINLINE uint32 GetSecondBit(uint32 Hash) { return (Hash >> 16) & (NumBits - 1); }
+
+		FORCEINLINE void SetBit(uint32 Bit)
+		{
+			Words[Bit / 64] |= uint64(1) << (Bit % 64);
+		}
+
+		FORCEINLINE bool IsBitSet(uint32 Bit) const
+		{
+			return (Words[Bit / 64] & (uint64(1) << (Bit % 64))) != 0;
+		}
+
+		uint64 Words[NumWords] = {};
+	};
+}
@@ -7,9 +7,114 @@
 #include "BindConflictBehavior.h"
 #include "DiContainerConcept.h"
 #include "Binding.h"
+#include "ClassAncestry.h"
+#include "PooledBinding.h"
 
 namespace DI
 {
+	namespace Private
+	{
+		/** @return the arena of the container if it has one, nullptr to allocate bindings from the heap otherwise. */
+		template <class TDiContainer>
+		FBindingArena* GetBindingArena(const TDiContainer& DiContainer)
+		{
+			if constexpr (requires { DiContainer.GetBindingArena(); })
+			{
+				return DiContainer.GetBindingArena();
+			}
+			else
+			{
+				return nullptr;
+			}
+		}
+	}
+
+	/**
+	 * Collects bindings and binds them all at once when committed.
+	 * Containers that implement BindSpecificMany insert the whole batch first and then notify subscribers and children in a single pass.
+	 * Commits automatically when it goes out of scope.
+	 * @code
+	 * DiContainer.Bind().Batch()
+	 *     .Instance<USimpleUService>(Service)
+	 *     .NamedInstance<FSimpleNativeService>(NativeService, "SomeName");
+	 * @endcode
+	 */
+	template <class TDiContainer>
+	class TBindingBatch
+	{
+	public:
+		TBindingBatch(TDiContainer& DiContainer, EBindConflictBehavior ConflictBehavior)
+			: DiContainer(DiContainer), ConflictBehavior(ConflictBehavior)
+		{
+		}
+
+		TBindingBatch(const TBindingBatch&) = delete;
+		TBindingBatch& operator=(const TBindingBatch&) = delete;
+
+		~TBindingBatch()
+		{
+			Commit();
+		}
+
+		/** Add an instance as its direct type to the batch. */
+		template <class T>
+		TBindingBatch& Instance(DI::TBindingInstRef<T> Instance)
+		{
+			PendingBindings.Emplace(DI::MakeBinding<DI::TBindingType<T>>(Private::GetBindingArena(DiContainer), MakeBindingId<T>(), Instance));
+			return *this;
+		}
+
+		/** Add a named instance as its direct type to the batch. */
+		template <class T>
+		TBindingBatch& NamedInstance(DI::TBindingInstRef<T> Instance, const FName& InstanceName)
+		{
+			PendingBindings.Emplace(DI::MakeBinding<DI::TBindingType<T>>(Private::GetBindingArena(DiContainer), MakeBindingId<T>(InstanceName), Instance));
+			return *this;
+		}
+
+		/** Add an already created binding to the batch. */
+		template <class TBinding>
+		TBindingBatch& AddBinding(TRefCountPtr<TBinding> Binding)
+		{
+			PendingBindings.Emplace(MoveTemp(Binding));
+			return *this;
+		}
+
+		/**
+		 * Bind all pending bindings.
+		 * @return Bound if all bindings have been bound, otherwise the result of the first binding that failed.
+		 */
+		EBindResult Commit()
+		{
+			if (PendingBindings.Num() == 0)
+				return EBindResult::Bound;
+
+			EBindResult OverallResult = EBindResult::Bound;
+			if constexpr (requires { DiContainer.BindSpecificMany(MakeArrayView(PendingBindings), ConflictBehavior); })
+			{
+				OverallResult = DiContainer.BindSpecificMany(MakeArrayView(PendingBindings), ConflictBehavior);
+			}
+			else
+			{
+				for (const TRefCountPtr<DI::FBinding>& PendingBinding : PendingBindings)
+				{
+					const EBindResult Result = DiContainer.BindSpecific(PendingBinding, ConflictBehavior);
+					if (OverallResult == EBindResult::Bound)
+					{
+						OverallResult = Result;
+					}
+				}
+			}
+			PendingBindings.Reset();
+			return OverallResult;
+		}
+
+	private:
+		TDiContainer& DiContainer;
+		EBindConflictBehavior ConflictBehavior;
+		TArray<TRefCountPtr<DI::FBinding>, TInlineAllocator<16>> PendingBindings;
+	};
+
 	/**
 	 * DiContainer agnostic implementation of common binding operations.
 	 * This helps in keeping the number of functions to be implemented for a DiContainer type to be very minimal
@@ -27,7 +132,7 @@ namespace DI
 		 * Binds an instance as its direct type
 		 * Keep in mind that when resolving this type, that you need to use the same type as it has been bound with.
 		 * Resolving via its parent class is not supported.
-		 * If you need to resolve a binding by multiple types, you can bind it to all required types manually.
+		 * If you need to resolve a UObject by its parent classes or interfaces, use Polymorphic. Other bindings have to be bound to all required types manually.
 		 */
 		template <class T>
 		EBindResult Instance(DI::TBindingInstRef<T> Instance, EBindConflictBehavior ConflictBehavior = GDefaultConflictBehavior)
@@ -40,7 +145,7 @@ namespace DI
 		 * Binds a named instance as its direct type
 		 * Keep in mind that when resolving this type, that you need to use the same type as it has been bound with.
 		 * Resolving via its parent class is not supported.
-		 * If you need to resolve a binding by multiple types, you can bind it to all required types manually.
+		 * If you need to resolve a UObject by its parent classes or interfaces, use Polymorphic. Other bindings have to be bound to all required types manually.
 		 */
 		template <class T>
 		EBindResult NamedInstance(
@@ -52,14 +157,130 @@ namespace DI
 			return this->RegisterBinding<T>(BindingId, Instance, ConflictBehavior);
 		}
 
+		/**
+		 * Binds a UObject as its runtime class and all of its super classes down to T, and as all interfaces that these classes implement.
+		 * Resolving via any of these types then finds the instance in a single lookup.
+		 * Super classes of T and the interfaces that only they implement are left out, because unrelated instances share them
+		 * and would be in conflict with each other. Pass a base class explicitly to bind beyond the static type, e.g. Polymorphic<UActorComponent>(Component).
+		 * Instances that are bound with the same name still conflict on every type they share, including common interfaces.
+		 */
+		template <class T>
+		EBindResult Polymorphic(TObjectPtr<T> Instance, EBindConflictBehavior ConflictBehavior = GDefaultConflictBehavior)
+		{
+			return this->RegisterPolymorphicBinding(Instance, GetTypeId<T>(), NAME_None, ConflictBehavior);
+		}
+
+		/**
+		 * Binds a UObject by name as its runtime class and all of its super classes down to T, and as all interfaces that these classes implement.
+		 * @see Polymorphic
+		 */
+		template <class T>
+		EBindResult NamedPolymorphic(TObjectPtr<T> Instance, const FName& InstanceName, EBindConflictBehavior ConflictBehavior = GDefaultConflictBehavior)
+		{
+			return this->RegisterPolymorphicBinding(Instance, GetTypeId<T>(), InstanceName, ConflictBehavior);
+		}
+
+		/**
+		 * Binds a factory that constructs the instance of T the first time it is resolved.
+		 * Use this for services that are not needed in every context to not pay for their construction up front.
+		 * The factory is called on the thread of the first resolve and released afterward. Resolves racing on other threads may call it as well,
+		 * but only one instance is kept. If somebody is already waiting for T, the instance is constructed as soon as the binding is bound.
+		 * @code
+		 * DiContainer.Bind().Lazy<FSimpleNativeService>([] { return MakeShared<FSimpleNativeService>(); });
+		 * @endcode
+		 */
+		template <class T>
+		EBindResult Lazy(typename DI::TLazyBinding<T>::FFactory Factory, EBindConflictBehavior ConflictBehavior = GDefaultConflictBehavior)
+		{
+			return this->RegisterLazyBinding<T>(MakeBindingId<T>(), MoveTemp(Factory), ConflictBehavior);
+		}
+
+		/**
+		 * Binds a factory that constructs the named instance of T the first time it is resolved.
+		 * @see Lazy
+		 */
+		template <class T>
+		EBindResult NamedLazy(
+			typename DI::TLazyBinding<T>::FFactory Factory,
+			const FName& InstanceName,
+			EBindConflictBehavior ConflictBehavior = GDefaultConflictBehavior)
+		{
+			return this->RegisterLazyBinding<T>(MakeBindingId<T>(InstanceName), MoveTemp(Factory), ConflictBehavior);
+		}
+
+		/**
+		 * Binds a pool that hands out a separate instance of T to everyone who acquires from it.
+		 * Instances are created with the factory when the pool is empty and up to Capacity released instances are kept for reuse.
+		 * Acquire instances with TResolveHelper::Acquire. Pools are separate from instance bindings of T.
+		 * @code
+		 * DiContainer.Bind().Pooled<FSimpleNativeService>([] { return MakeShared<FSimpleNativeService>(); }, 16);
+		 * @endcode
+		 */
+		template <class T>
+		EBindResult Pooled(
+			typename DI::TPooledBinding<T>::FFactory Factory,
+			int32 Capacity,
+			EBindConflictBehavior ConflictBehavior = GDefaultConflictBehavior)
+		{
+			return this->RegisterPooledBinding<T>(MakePoolBindingId<T>(), MoveTemp(Factory), Capacity, ConflictBehavior);
+		}
+
+		/**
+		 * Binds a named pool that hands out a separate instance of T to everyone who acquires from it.
+		 * @see Pooled
+		 */
+		template <class T>
+		EBindResult NamedPooled(
+			typename DI::TPooledBinding<T>::FFactory Factory,
+			int32 Capacity,
+			const FName& PoolName,
+			EBindConflictBehavior ConflictBehavior = GDefaultConflictBehavior)
+		{
+			return this->RegisterPooledBinding<T>(MakePoolBindingId<T>(PoolName), MoveTemp(Factory), Capacity, ConflictBehavior);
+		}
+
+		/**
+		 * Adds an instance to the unnamed set of T.
+		 * Sets can be added to any number of times and are resolved with TResolveHelper::GetAll or TResolveHelper::ForEachInSet.
+		 * @code
+		 * DiContainer.Bind().AddToSet<ISimpleInterface>(FirstHandler);
+		 * DiContainer.Bind().AddToSet<ISimpleInterface>(SecondHandler);
+		 * @endcode
+		 */
+		template <class T>
+		EBindResult AddToSet(DI::TBindingInstRef<T> Instance)
+		{
+			return this->RegisterSetBinding<T>(MakeSetBindingId<T>(), Instance);
+		}
+
+		/**
+		 * Adds an instance to the named set of T.
+		 * Sets with different names are independent of each other and of the unnamed set.
+		 */
+		template <class T>
+		EBindResult AddToNamedSet(DI::TBindingInstRef<T> Instance, const FName& SetName)
+		{
+			return this->RegisterSetBinding<T>(MakeSetBindingId<T>(SetName), Instance);
+		}
+
+		/**
+		 * Start a batch of bindings that are bound together once the batch is committed or goes out of scope.
+		 * Prefer this when binding many instances at once, e.g. during initialization of a context.
+		 */
+		TBindingBatch<TDiContainer> Batch(EBindConflictBehavior ConflictBehavior = GDefaultConflictBehavior)
+		{
+			return TBindingBatch<TDiContainer>(DiContainer, ConflictBehavior);
+		}
+
 
 	private:
 		template <class T>
-		TSharedPtr<DI::TBindingType<T>> FindBinding(const FBindingId& BindingId) const
+		TRefCountPtr<DI::TBindingType<T>> FindBinding(const FBindingId& BindingId) const
 		{
-			if (const TSharedPtr<DI::FBinding> DependencyBinding = DiContainer.FindBinding(BindingId))
+			if (const TRefCountPtr<DI::FBinding> DependencyBinding = DiContainer.FindBinding(BindingId))
 			{
-				return StaticCastSharedPtr<DI::TBindingType<T>>(DependencyBinding);
+				const DI::FBinding& InstanceBinding = DependencyBinding->GetInstanceBinding();
+				return TRefCountPtr<DI::TBindingType<T>>(static_cast<DI::TBindingType<T>*>(const_cast<DI::FBinding*>(&InstanceBinding)));
 			}
 			return nullptr;
 		}
@@ -72,10 +293,63 @@ namespace DI
 		                            DI::TBindingInstRef<T> Instance,
 		                            EBindConflictBehavior ConflictBehavior)
 		{
-			TSharedRef<DI::TBindingType<T>> ConcreteBinding = MakeShared<DI::TBindingType<T>>(BindingId, Instance);
+			TRefCountPtr<DI::FBinding> ConcreteBinding(DI::MakeBinding<DI::TBindingType<T>>(Private::GetBindingArena(DiContainer), BindingId, Instance));
 			return DiContainer.BindSpecific(ConcreteBinding, ConflictBehavior);
 		}
 
+		template <class T>
+		EBindResult RegisterLazyBinding(const FBindingId& BindingId, typename DI::TLazyBinding<T>::FFactory Factory, EBindConflictBehavior ConflictBehavior)
+		{
+			TRefCountPtr<DI::FBinding> LazyBinding(DI::MakeBinding<DI::TLazyBinding<T>>(Private::GetBindingArena(DiContainer), BindingId, MoveTemp(Factory)));
+			return DiContainer.BindSpecific(LazyBinding, ConflictBehavior);
+		}
+
+		template <class T>
+		EBindResult RegisterPooledBinding(
+			const FBindingId& PoolId,
+			typename DI::TPooledBinding<T>::FFactory Factory,
+			int32 Capacity,
+			EBindConflictBehavior ConflictBehavior)
+		{
+			TRefCountPtr<DI::FBinding> PooledBinding(DI::MakeBinding<DI::TPooledBinding<T>>(Private::GetBindingArena(DiContainer), PoolId, MoveTemp(Factory), Capacity));
+			return DiContainer.BindSpecific(PooledBinding, ConflictBehavior);
+		}
+
+		template <class T>
+		EBindResult RegisterSetBinding(const FBindingId& SetId, DI::TBindingInstRef<T> Instance)
+		{
+			// Containers append to the set if it is already bound, so this never conflicts.
+			TRefCountPtr<DI::FBinding> SetBinding(DI::MakeBinding<DI::TBindingSet<T>>(Private::GetBindingArena(DiContainer), SetId, Instance));
+			return DiContainer.BindSpecific(SetBinding, EBindConflictBehavior::None);
+		}
+
+		EBindResult RegisterPolymorphicBinding(UObject* Instance, const FTypeId& BaseClassId, const FName& InstanceName, EBindConflictBehavior ConflictBehavior)
+		{
+			check(Instance);
+			const FClassAncestry& Ancestry = FClassAncestry::Get(Instance->GetClass());
+			FBindingArena* Arena = Private::GetBindingArena(DiContainer);
+
+			// UObject is not part of the ancestry, so binding down to UObject binds all of it.
+			const int32 BaseClassIndex = Ancestry.SuperClasses.IndexOfByKey(BaseClassId);
+			const int32 LastSuperClassIndex = BaseClassIndex != INDEX_NONE ? BaseClassIndex : Ancestry.SuperClasses.Num() - 1;
+
+			TBindingBatch<TDiContainer> Batch(DiContainer, ConflictBehavior);
+			for (int32 SuperClassIndex = 0; SuperClassIndex <= LastSuperClassIndex; ++SuperClassIndex)
+			{
+				const FBindingId BindingId(Ancestry.SuperClasses[SuperClassIndex], InstanceName);
+				Batch.AddBinding(DI::MakeBinding<DI::TUObjectBinding<UObject>>(Arena, BindingId, Instance));
+			}
+			for (const FClassAncestry::FInterface& AncestorInterface : Ancestry.Interfaces)
+			{
+				if (AncestorInterface.SuperClassIndex > LastSuperClassIndex)
+					continue;
+
+				FScriptInterface Interface(Instance, Instance->GetInterfaceAddress(AncestorInterface.Class));
+				Batch.AddBinding(DI::MakeBinding<DI::FUInterfaceBinding>(Arena, FBindingId(AncestorInterface.TypeId, InstanceName), Interface));
+			}
+			return Batch.Commit();
+		}
+
 	private:
 		TDiContainer& DiContainer;
 	};
@@ -2,12 +2,14 @@
 
 #pragma once
 #include "TypeId.h"
+#include "BindingKey.h"
 
 namespace DI
 {
 	/**
 	 * ID for a binding.
 	 * Consists of a TypeID and a Name.
+	 * Caches the packed FBindingKey that containers use for lookups.
 	 */
 	class TENTACLE_API FBindingId
 	{
@@ -15,12 +17,17 @@ namespace DI
 		FBindingId() = default;
 
 		explicit FBindingId(FTypeId InBoundTypeId)
-			: BoundTypeId(MoveTemp(InBoundTypeId)), BindingName(NAME_None)
+			: BoundTypeId(MoveTemp(InBoundTypeId)), BindingName(NAME_None), Key(BoundTypeId.GetTypeIndex(), BindingName)
 		{
 		}
 
 		explicit FBindingId(FTypeId InBoundTypeId, FName InBindingName)
-			: BoundTypeId(MoveTemp(InBoundTypeId)), BindingName(MoveTemp(InBindingName))
+			: BoundTypeId(MoveTemp(InBoundTypeId)), BindingName(MoveTemp(InBindingName)), Key(BoundTypeId.GetTypeIndex(), BindingName)
+		{
+		}
+
+		explicit FBindingId(FTypeId InBoundTypeId, FName InBindingName, EBindingKind Kind)
+			: BoundTypeId(MoveTemp(InBoundTypeId)), BindingName(MoveTemp(InBindingName)), Key(BoundTypeId.GetTypeIndex(), BindingName, Kind)
 		{
 		}
 
@@ -41,20 +48,37 @@ namespace DI
 			return BindingName;
 		}
 
+		/** Get the packed key that is used for lookups in containers. */
+		FORCEINLINE const FBindingKey& GetKey() const
+		{
+			return Key;
+		}
+
+		FORCEINLINE EBindingKind GetKind() const
+		{
+			return Key.GetKind();
+		}
+
+		FORCEINLINE bool IsSet() const
+		{
+			return Key.IsSet();
+		}
+
 		FORCEINLINE FString ToString() const
 		{
-			return FString::Printf(TEXT("%s:%s"), *BoundTypeId.GetName().ToString(), *BindingName.ToString());
+			const TCHAR* KindSuffix = GetKind() == EBindingKind::Set ? TEXT("[]") : GetKind() == EBindingKind::Pool ? TEXT("[Pool]") : TEXT("");
+			return FString::Printf(TEXT("%s%s:%s"), *BoundTypeId.GetName().ToString(), KindSuffix, *BindingName.ToString());
 		}
 
 	private:
 		FTypeId BoundTypeId = {};
 		FName BindingName = NAME_None;
+		FBindingKey Key = {};
 	};
 
 	FORCEINLINE bool operator==(const FBindingId& A, const FBindingId& B)
 	{
-		return A.GetBoundTypeId() == B.GetBoundTypeId()
-			&& A.GetBindingName() == B.GetBindingName();
+		return A.GetKey() == B.GetKey();
 	}
 
 	template <class T>
@@ -69,10 +93,32 @@ namespace DI
 		return FBindingId(DI::GetTypeId<T>(), MoveTemp(BindingName));
 	}
 
+	/** Make the ID of the set of T with the given name. */
+	template <class T>
+	static FBindingId MakeSetBindingId(FName SetName = NAME_None)
+	{
+		return FBindingId(DI::GetTypeId<T>(), MoveTemp(SetName), EBindingKind::Set);
+	}
+
+	/** Make the ID of the pool of T with the given name. */
+	template <class T>
+	static FBindingId MakePoolBindingId(FName PoolName = NAME_None)
+	{
+		return FBindingId(DI::GetTypeId<T>(), MoveTemp(PoolName), EBindingKind::Pool);
+	}
+
+	/** Get the lookup key of the unnamed binding of T without building a binding ID. */
+	template <class T>
+	const FBindingKey& GetUnnamedBindingKey()
+	{
+		static const FBindingKey UnnamedBindingKey = FBindingKey(DI::GetTypeId<T>().GetTypeIndex(), NAME_None);
+		return UnnamedBindingKey;
+	}
+
 	
 	FORCEINLINE uint32 GetTypeHash(const DI::FBindingId& Binding)
 	{
-		return HashCombine(::GetTypeHash(Binding.GetBoundTypeId()), GetTypeHash(Binding.GetBindingName()));
+		return Binding.GetKey().GetHash();
 	}
 }
 
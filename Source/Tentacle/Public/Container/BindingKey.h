@@ -0,0 +1,116 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace DI
+{
+	/**
+	 * What a binding ID refers to.
+	 */
+	enum class EBindingKind : uint8
+	{
+		// A single instance. Binding a second instance for the same ID is a conflict.
+		Instance,
+
+		// A set of instances that can be added to from anywhere and is resolved as a whole.
+		Set,
+
+		// A pool that hands out a separate instance to everyone who acquires from it.
+		Pool,
+	};
+
+	/**
+	 * Packed lookup key for a binding.
+	 * Consists of the dense type index of the bound type and the comparison index and number of the binding name.
+	 * The kind of the binding is stored in the highest bits of the name number, so bindings of different kinds never collide.
+	 * The hash is computed once on construction, so lookups only ever compare two machine words.
+	 * Only valid for the lifetime of the process, so never serialize it.
+	 */
+	class FBindingKey
+	{
+	public:
+		FBindingKey() = default;
+
+		FBindingKey(uint32 TypeIndex, FName BindingName, EBindingKind Kind = EBindingKind::Instance)
+			: TypeAndName((static_cast<uint64>(TypeIndex) << 32) | BindingName.GetComparisonIndex().ToUnstableInt())
+			  , NameNumber(BindingName.GetNumber() | (static_cast<uint32>(Kind) << KindShift))
+			  , Hash(ComputeHash(TypeAndName, NameNumber))
+		{
+		}
+
+		FORCEINLINE uint32 GetTypeIndex() const
+		{
+			return static_cast<uint32>(TypeAndName >> 32);
+		}
+
+		/** @return true if the key was built from NAME_None for a single instance. */
+		FORCEINLINE bool IsUnnamed() const
+		{
+			return static_cast<uint32>(TypeAndName) == 0 && NameNumber == 0;
+		}
+
+		FORCEINLINE EBindingKind GetKind() const
+		{
+			return static_cast<EBindingKind>(NameNumber >> KindShift);
+		}
+
+		FORCEINLINE bool IsSet() const
+		{
+			return GetKind() == EBindingKind::Set;
+		}
+
+		FORCEINLINE uint32 GetHash() const
+		{
+			return Hash;
+		}
+
+		/**
+		 * Hash of the whole key mixed with the seed.
+		 * Unlike the cached hash, two different keys only share it for a few seeds, so it can tell keys apart whose cached hashes collide.
+		 */
+		FORCEINLINE uint32 GetSeededHash(uint32 Seed) const
+		{
+			return ComputeHash(TypeAndName ^ (static_cast<uint64>(Seed) * 0xD6E8FEB86659FD93ull), NameNumber);
+		}
+
+		FORCEINLINE bool operator==(const FBindingKey& Other) const
+		{
+			return TypeAndName == Other.TypeAndName && NameNumber == Other.NameNumber;
+		}
+
+		FORCEINLINE bool operator!=(const FBindingKey& Other) const
+		{
+			return !(*this == Other);
+		}
+
+	private:
+		/** Name numbers never get anywhere close to this, so the bits above are free to store the kind. */
+		static constexpr uint32 KindShift = 30;
+
+		static FORCEINLINE uint32 ComputeHash(uint64 TypeAndName, uint32 NameNumber)
+		{
+			// murmur3 finalizer so the low and high bits of the hash are both usable for bucketing.
+			uint64 Mixed = TypeAndName ^ (static_cast<uint64>(NameNumber) * 0x9E3779B97F4A7C15ull);
+			Mixed ^= Mixed >> 33;
+			Mixed *= 0xFF51AFD7ED558CCDull;
+			Mixed ^= Mixed >> 33;
+			Mixed *= 0xC4CEB9FE1A85EC53ull;
+			Mixed ^= Mixed >> 33;
+			return static_cast<uint32>(Mixed);
+		}
+
+		/** Type index in the upper half, name comparison index in the lower half. */
+		uint64 TypeAndName = 0;
+		uint32 NameNumber = 0;
+		uint32 Hash = 0;
+	};
+
+	static_assert(sizeof(FBindingKey) == 16, "Binding keys should stay small enough to be compared in two machine words.");
+
+	FORCEINLINE uint32 GetTypeHash(const FBindingKey& BindingKey)
+	{
+		return BindingKey.GetHash();
+	}
+}
@@ -0,0 +1,18 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace DI
+{
+	enum class EBindingNotificationMode : uint8
+	{
+		// Subscribers are notified inside the bind call that fulfills them.
+		Immediate,
+
+		// Bindings are queued and subscribers are notified at the end of the frame or when notifications are flushed explicitly.
+		// Bindings of the same key that are bound in the same frame are coalesced, so subscribers only see the last one.
+		Deferred,
+	};
+}
@@ -0,0 +1,112 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Binding.h"
+#include "BindingKey.h"
+
+namespace DI
+{
+	/**
+	 * Small open addressing cache of bindings that a connected container has resolved from its ancestors.
+	 * Only stores the keys that have actually been looked up, so it stays small no matter how many types are registered.
+	 * Entries are never removed one by one. The owner resets the whole cache when the bindings of its ancestors change,
+	 * and it resets itself instead of growing past MaxNumSlots.
+	 */
+	class FBindingResolveCache
+	{
+	public:
+		static constexpr int32 MinNumSlots = 16;
+		static constexpr int32 MaxNumSlots = 1024;
+
+		FORCEINLINE const TRefCountPtr<DI::FBinding>* Find(const FBindingKey& Key) const
+		{
+			if (NumElements == 0)
+				return nullptr;
+
+			const uint32 Mask = static_cast<uint32>(Slots.Num() - 1);
+			for (uint32 Index = Key.GetHash() & Mask;; Index = (Index + 1) & Mask)
+			{
+				const FSlot& Slot = Slots[Index];
+				if (!Slot.Binding.IsValid())
+					return nullptr;
+				if (Slot.Key == Key)
+					return &Slot.Binding;
+			}
+		}
+
+		/** Cache a binding for a key that is not cached yet. */
+		void Add(const FBindingKey& Key, TRefCountPtr<DI::FBinding> Binding)
+		{
+			check(Binding.IsValid());
+			// Keep the load factor at or below 3/4 so probe sequences stay short and always end in an empty slot.
+			if ((NumElements + 1) * 4 > Slots.Num() * 3)
+			{
+				if (Slots.Num() >= MaxNumSlots)
+				{
+					Reset();
+				}
+				else
+				{
+					Grow();
+				}
+			}
+
+			const uint32 Mask = static_cast<uint32>(Slots.Num() - 1);
+			uint32 Index = Key.GetHash() & Mask;
+			while (Slots[Index].Binding.IsValid())
+			{
+				check(Slots[Index].Key != Key);
+				Index = (Index + 1) & Mask;
+			}
+			Slots[Index].Key = Key;
+			Slots[Index].Binding = MoveTemp(Binding);
+			++NumElements;
+		}
+
+		/** Drop all cached bindings but keep the memory of the slots for reuse. */
+		void Reset()
+		{
+			if (NumElements == 0)
+				return;
+
+			for (FSlot& Slot : Slots)
+			{
+				Slot.Binding.SafeRelease();
+			}
+			NumElements = 0;
+		}
+
+		FORCEINLINE int32 Num() const
+		{
+			return NumElements;
+		}
+
+	private:
+		struct FSlot
+		{
+			FBindingKey Key;
+			/** Empty slots have no binding. */
+			TRefCountPtr<DI::FBinding> Binding;
+		};
+
+		void Grow()
+		{
+			TArray<FSlot> OldSlots = MoveTemp(Slots);
+			Slots.SetNum(FMath::Max(MinNumSlots, OldSlots.Num() * 2));
+			NumElements = 0;
+			for (FSlot& OldSlot : OldSlots)
+			{
+				if (OldSlot.Binding.IsValid())
+				{
+					Add(OldSlot.Key, MoveTemp(OldSlot.Binding));
+				}
+			}
+		}
+
+		/** Power of two number of slots, probed linearly starting at the hash of the key. */
+		TArray<FSlot> Slots;
+		int32 NumElements = 0;
+	};
+}
@@ -5,26 +5,176 @@
 #include "CoreMinimal.h"
 #include "Binding.h"
 #include "BindingId.h"
+#include "BindingKey.h"
 
 namespace DI
 {
 	/**
-	 * Keeps the list of pending subscribers per binding ID.
+	 * Identifies a single subscription in a FBindingSubscriptionList.
+	 * Stays unique after the subscription is gone, so stale handles can never remove somebody else's subscription.
+	 */
+	struct FBindingSubscriptionHandle
+	{
+		int32 WaiterIndex = INDEX_NONE;
+		uint32 Serial = 0;
+
+		FORCEINLINE bool IsValid() const
+		{
+			return WaiterIndex != INDEX_NONE;
+		}
+	};
+
+	enum class EUnsubscribeResult : uint8
+	{
+		/** The handle does not belong to a subscription that is still waiting. */
+		NotSubscribed,
+		/** The waiter has been removed. Other waiters of its key are still pending. */
+		Removed,
+		/** The waiter has been removed and was the last one of its key, so the key is not pending anymore. */
+		RemovedLastWaiter,
+		/** The key is being notified right now. The waiter is skipped and the notification stops the key from being pending on its own. */
+		Cancelled,
+	};
+
+	/**
+	 * Keeps the list of pending subscribers per binding key.
+	 *
+	 * Waiters are nodes in pages of fixed size, so subscribing does not allocate once the pages are warm and nodes never move.
+	 * Every pending key owns a doubly linked list of waiters that is walked in place when the key is bound.
+	 * Unsubscribing unlinks and frees the waiter in O(1), so cancelled waiters never pile up while others keep waiting.
 	 */
 	class TENTACLE_API FBindingSubscriptionList
 	{
 	public:
-		using FOnInstanceBound = TMulticastDelegate<void(const DI::FBinding&)>;
-		using FOnInstanceBoundUnicast = FOnInstanceBound::FDelegate;
+		using FOnInstanceBound = TUniqueFunction<void(const DI::FBinding&)>;
+
+		FBindingSubscriptionList() = default;
+		/** Subscriptions are one-shot and belong to the container they were made in, so copies start without any. */
+		FBindingSubscriptionList(const FBindingSubscriptionList&);
+		FBindingSubscriptionList& operator=(const FBindingSubscriptionList&);
+		~FBindingSubscriptionList();
+
+		/**
+		 * Register a callback that is invoked a single time when the binding with the given key is bound.
+		 * @param WaitingObject - (Optional) if set, the callback is dropped without being invoked once the object has been destroyed.
+		 */
+		FBindingSubscriptionHandle Subscribe(const FBindingKey& BindingKey, FOnInstanceBound&& Callback, const UObject* WaitingObject = nullptr);
+
+		/**
+		 * @param BindingKey - the key the handle has been subscribed with
+		 * @return whether the subscription has been removed and if its key is still pending.
+		 */
+		EUnsubscribeResult Unsubscribe(const FBindingKey& BindingKey, FBindingSubscriptionHandle Handle);
+
+		/** @return true if there were subscriptions for the binding. */
+		bool NotifyInstanceBound(const DI::FBinding& Binding);
+
+		/**
+		 * Drop all waiters whose waiting object has been destroyed.
+		 * @param OutAbandonedCallbacks - receives the callbacks of the dropped waiters. Destroying them cancels their futures,
+		 *        whose continuations may do anything, including destroying the owner of this list.
+		 * @return the keys that are not pending anymore because all of their waiters have been dropped.
+		 */
+		TArray<FBindingKey> RemoveAbandonedWaiters(TArray<FOnInstanceBound>& OutAbandonedCallbacks);
+
+		TArray<FBindingKey> GetAllPendingBindingKeys() const;
+
+		FORCEINLINE bool IsPending(const FBindingKey& BindingKey) const
+		{
+			return KeyToWaiters.Contains(BindingKey);
+		}
+
+	private:
+		static constexpr int32 WaitersPerPage = 256;
+
+		struct FWaiter
+		{
+			/** Unset if the waiter is free or has been unsubscribed. */
+			FOnInstanceBound Callback;
+			TWeakObjectPtr<const UObject> WaitingObject;
+			bool bHasWaitingObject = false;
+			/** Next waiter of the same key, or the next free waiter. */
+			int32 Next = INDEX_NONE;
+			/** Previous waiter of the same key. */
+			int32 Prev = INDEX_NONE;
+			/** Id of the list the waiter is in. */
+			uint32 ListId = 0;
+			/** Incremented whenever the waiter is freed to invalidate outstanding handles. */
+			uint32 Serial = 0;
+		};
+
+		struct FWaiterList
+		{
+			int32 Head = INDEX_NONE;
+			int32 Tail = INDEX_NONE;
+			/** Number of waiters in the list. */
+			int32 NumSubscribed = 0;
+			/** Unique per list, so waiters of a list that is being notified are not mistaken for waiters of a new list of the same key. */
+			uint32 ListId = 0;
+		};
+
+		FORCEINLINE FWaiter& GetWaiter(int32 WaiterIndex) const
+		{
+			return Pages[WaiterIndex / WaitersPerPage][WaiterIndex % WaitersPerPage];
+		}
+
+		int32 AllocateWaiter();
+		void FreeWaiter(int32 WaiterIndex);
+		/** Remove the waiter from the list without freeing it. */
+		void UnlinkWaiter(FWaiterList& WaiterList, int32 WaiterIndex);
+
+		TMap<FBindingKey, FWaiterList> KeyToWaiters = {};
+
+		TArray<TUniquePtr<FWaiter[]>> Pages;
+		int32 FirstFreeWaiter = INDEX_NONE;
+		uint32 LastListId = 0;
+		/** Waiters with a waiting object. RemoveAbandonedWaiters has nothing to do if there are none. */
+		int32 NumWaitersWithWaitingObject = 0;
+		/** Number of waiters that have ever been handed out of the pages. */
+		int32 NumUsedWaiters = 0;
+	};
+
+	/**
+	 * Counts how many sources wait for a binding key, e.g. a container itself and each of its children that have waiters in their subtree.
+	 * Connected containers use it to skip notifying branches where nobody is waiting.
+	 */
+	class TENTACLE_API FPendingKeyIndex
+	{
+	public:
+		/** @return true if the key has not been pending before. */
+		bool Add(const FBindingKey& BindingKey);
+
+		/** @return true if the key is not pending anymore. */
+		bool Remove(const FBindingKey& BindingKey);
+
+		FORCEINLINE int32 GetCount(const FBindingKey& BindingKey) const
+		{
+			const int32* Count = KeyToCount.Find(BindingKey);
+			return Count ? *Count : 0;
+		}
+
+		FORCEINLINE bool Contains(const FBindingKey& BindingKey) const
+		{
+			return KeyToCount.Contains(BindingKey);
+		}
 
-		bool Unsubscribe(const FBindingId& BindingId, FDelegateHandle DelegateHandle);
+		FORCEINLINE bool IsEmpty() const
+		{
+			return KeyToCount.IsEmpty();
+		}
 
-		void NotifyInstanceBound(const DI::FBinding& Binding);
+		TArray<FBindingKey> GetKeys() const;
 
-		FOnInstanceBound& SubscribeOnce(const FBindingId& BindingId);
-		TArray<FBindingId> GetAllPendingBindingIds() const;
+		template<typename FunctorType>
+		void ForEachKey(FunctorType&& Functor) const
+		{
+			for (const TPair<FBindingKey, int32>& KeyAndCount : KeyToCount)
+			{
+				Functor(KeyAndCount.Key);
+			}
+		}
 
 	private:
-		TMap<FBindingId, FOnInstanceBound> BindingToSubscriptions = {};
+		TMap<FBindingKey, int32> KeyToCount = {};
 	};
 }
@@ -0,0 +1,183 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Binding.h"
+#include "BindingKey.h"
+
+/**
+ * If enabled, unnamed bindings of types with a type index below TENTACLE_MAX_UNNAMED_BINDING_SLOTS are stored in an array
+ * that is indexed by the type index of their binding key, so looking them up is a single array access instead of a hash probe.
+ * This costs one slot per type index up to the highest of these type indices that has been bound in a table.
+ * All other bindings go into the hashed slots.
+ */
+#ifndef TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+#define TENTACLE_WITH_UNNAMED_BINDING_SLOTS 1
+#endif
+
+/**
+ * Upper bound for the number of unnamed slots per table.
+ * Unnamed bindings of types with a higher type index go into the hashed slots, so a table never pays for the global type count.
+ */
+#ifndef TENTACLE_MAX_UNNAMED_BINDING_SLOTS
+#define TENTACLE_MAX_UNNAMED_BINDING_SLOTS 128
+#endif
+
+namespace DI
+{
+	/**
+	 * Open addressing hash table that maps binding keys to bindings.
+	 *
+	 * Modelled after swiss tables: every slot has a control byte that holds 7 bits of the hash of its key,
+	 * so a lookup can match a whole group of slots with a single SIMD compare before touching any key.
+	 * Keys and binding pointers are stored inline in one slot array, so a hit costs one control group and one slot
+	 * instead of the bucket, sparse array and element hops of a TMap.
+	 */
+	class TENTACLE_API FBindingTable
+	{
+	public:
+		struct FSlot
+		{
+			FBindingKey Key;
+			TRefCountPtr<DI::FBinding> Binding;
+		};
+
+		/** Iterates the hashed slots first and the unnamed slots afterward. */
+		template <class TTable, class TSlot>
+		class TIterator
+		{
+		public:
+			TIterator(TTable& InTable, int32 InIndex)
+				: Table(InTable), Index(InIndex)
+			{
+				SkipEmptySlots();
+			}
+
+			TSlot& operator*() const { return GetSlot(); }
+			TSlot* operator->() const { return &GetSlot(); }
+
+			TIterator& operator++()
+			{
+				++Index;
+				SkipEmptySlots();
+				return *this;
+			}
+
+			bool operator!=(const TIterator& Other) const { return Index != Other.Index; }
+
+		private:
+			TSlot& GetSlot() const
+			{
+				const int32 NumHashedSlots = Table.Slots.Num();
+				return Index < NumHashedSlots ? Table.Slots[Index] : Table.GetUnnamedSlots()[Index - NumHashedSlots];
+			}
+
+			void SkipEmptySlots()
+			{
+				const int32 NumHashedSlots = Table.Slots.Num();
+				while (Index < NumHashedSlots && Table.Controls[Index] < 0)
+				{
+					++Index;
+				}
+
+				const int32 NumSlots = Table.GetNumIteratedSlots();
+				while (Index >= NumHashedSlots && Index < NumSlots && !Table.GetUnnamedSlots()[Index - NumHashedSlots].Binding.IsValid())
+				{
+					++Index;
+				}
+			}
+
+			TTable& Table;
+			int32 Index;
+		};
+
+		using FIterator = TIterator<FBindingTable, FSlot>;
+		using FConstIterator = TIterator<const FBindingTable, const FSlot>;
+
+		/** Find the binding for the given key. */
+		TRefCountPtr<DI::FBinding>* Find(const FBindingKey& Key);
+		const TRefCountPtr<DI::FBinding>* Find(const FBindingKey& Key) const;
+
+		/** Add a binding or replace the binding that is already stored for its key. */
+		void Emplace(const FBindingKey& Key, TRefCountPtr<DI::FBinding> Binding);
+
+		/** @return true if a binding with the given key has been removed. */
+		bool Remove(const FBindingKey& Key);
+
+		/** Make sure that NumBindings named bindings can be stored without rehashing. */
+		void Reserve(int32 NumBindings);
+
+		void Empty();
+
+		/** Remove all bindings but keep the memory of the slots for reuse. */
+		void Reset();
+
+		FORCEINLINE int32 Num() const
+		{
+			return NumElements + NumUnnamed;
+		}
+
+		/**
+		 * Report the references of all bindings to the garbage collector.
+		 * Bindings that reference a single UObject are reported in bulk from a cached array of their reference slots
+		 * and bindings without references are skipped, so only the remaining bindings are asked to report their references.
+		 */
+		void AddReferencedObjects(FReferenceCollector& Collector);
+
+		FIterator begin() { return FIterator(*this, 0); }
+		FIterator end() { return FIterator(*this, GetNumIteratedSlots()); }
+		FConstIterator begin() const { return FConstIterator(*this, 0); }
+		FConstIterator end() const { return FConstIterator(*this, GetNumIteratedSlots()); }
+
+	private:
+		/** Rebuild ObjectReferenceSlots and BindingsWithComplexReferences from the bindings in the table. */
+		void RebuildReferenceCache();
+
+		int32 FindSlotIndex(const FBindingKey& Key) const;
+		int32 FindInsertIndex(uint32 Hash) const;
+		void Rehash(int32 MinNumBindings);
+
+		FORCEINLINE int32 GetNumIteratedSlots() const
+		{
+			return Slots.Num() + GetUnnamedSlots().Num();
+		}
+
+		/** @return true if the binding for the key is stored in the unnamed slots instead of the hashed slots. */
+		static FORCEINLINE bool UsesUnnamedSlot(const FBindingKey& Key)
+		{
+#if TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+			return Key.IsUnnamed() && Key.GetTypeIndex() < TENTACLE_MAX_UNNAMED_BINDING_SLOTS;
+#else
+			return false;
+#endif
+		}
+
+#if TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+		FORCEINLINE TArray<FSlot>& GetUnnamedSlots() { return UnnamedSlots; }
+		FORCEINLINE const TArray<FSlot>& GetUnnamedSlots() const { return UnnamedSlots; }
+#else
+		FORCEINLINE TArrayView<FSlot> GetUnnamedSlots() { return {}; }
+		FORCEINLINE TArrayView<const FSlot> GetUnnamedSlots() const { return {}; }
+#endif
+
+		/** One control byte per slot. Negative values mark empty or deleted slots, full slots store the low 7 bits of the hash. */
+		TArray<int8> Controls;
+		TArray<FSlot> Slots;
+		int32 NumElements = 0;
+		int32 NumDeleted = 0;
+
+#if TENTACLE_WITH_UNNAMED_BINDING_SLOTS
+		/** Unnamed bindings indexed by the type index of their key, up to TENTACLE_MAX_UNNAMED_BINDING_SLOTS. Slots without a binding are empty. */
+		TArray<FSlot> UnnamedSlots;
+#endif
+		int32 NumUnnamed = 0;
+
+		/** Reference slots of all bindings that only reference a single UObject. */
+		TArray<TObjectPtr<UObject>*> ObjectReferenceSlots;
+		/** Bindings that have to report their references themselves. */
+		TArray<DI::FBinding*> BindingsWithComplexReferences;
+		/** Set whenever bindings are added or removed, so the reference cache is only rebuilt on the next garbage collection after a change. */
+		bool bIsReferenceCacheDirty = false;
+	};
+}
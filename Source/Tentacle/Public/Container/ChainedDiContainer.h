@@ -3,18 +3,38 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "BindingResolveCache.h"
+#include "BindingTable.h"
 #include "DiContainer.h"
+#include "FrozenBindingTable.h"
 #include "ChainedDiContainer.generated.h"
 
 namespace DI
 {
+	/**
+	 * Specifies how a frozen container reacts to new bindings.
+	 */
+	enum class EFrozenBindBehavior : uint8
+	{
+		// Reject new bindings with EBindResult::Frozen.
+		Reject,
+
+		// Accept new bindings and rebuild the frozen table with them.
+		CopyOnWrite,
+	};
+
 	/**
 	 * DI Container that can defer resolving of bindings to its single parent.
 	 *
 	 * Binding will cause the container to notify its children that a new binding has been bound.
+	 * Every container keeps an index of the keys that are pending anywhere in its subtree, so only branches with waiters for a key are notified.
 	 * This behavior to prevent the memory overhead of duplicate bindings in favor of worse performance at bind and resolve time.
 	 *
-	 * Children do not cache bindings that have been bound in parent containers.
+	 * Ancestor lookups loop over a flattened array of the tables of all ancestors, which is rebuilt whenever the chain changes,
+	 * so they neither dispatch virtually nor pin any weak pointers.
+	 * Bindings that have been resolved from ancestors are additionally cached per child. Every container counts a binding generation
+	 * that changes whenever its own bindings change, and the cache is dropped once the sum of the generations of all LookupTables differs
+	 * from the sum it has been filled at, so binding in unrelated containers keeps it intact.
 	 */
 	class TENTACLE_API FChainedDiContainer final
 		: public TSharedFromThis<FChainedDiContainer>
@@ -22,12 +42,12 @@ namespace DI
 		  , public FDiContainerBase
 	{
 	public:
-		FChainedDiContainer() = default;
+		FChainedDiContainer();
 
 		// Technically, we could have a copy constructor, but copying is usually a user error, so we delete it to catch these cases earlier.
 		FChainedDiContainer(const FChainedDiContainer&) = delete;
 
-		virtual ~FChainedDiContainer() override = default;
+		virtual ~FChainedDiContainer() override;
 
 		/**
 		 * Sets the chained parent of this DI Container.
@@ -38,6 +58,21 @@ namespace DI
 		/** Call this from the owning type to prevent types and bindings to be garbage collected. */
 		void AddReferencedObjects(FReferenceCollector& Collector);
 
+		/**
+		 * Compile the bindings of this container into an immutable perfect hash table so every local lookup costs a single probe.
+		 * Intended for containers that are bound once and only read from afterward, e.g. the engine and game instance scopes.
+		 * @param BindBehavior - how to handle binds while the container is frozen.
+		 */
+		void Freeze(EFrozenBindBehavior BindBehavior = EFrozenBindBehavior::Reject);
+
+		/** Drop the frozen table and go back to regular binding and lookups. */
+		void Thaw();
+
+		FORCEINLINE bool IsFrozen() const
+		{
+			return bIsFrozen;
+		}
+
 		/** Get the Binding API */
 		TBindingHelper<FChainedDiContainer> Bind() { return TBindingHelper(*this); }
 		/** Get the Resolving API */
@@ -47,41 +82,104 @@ namespace DI
 
 		// - FDiContainerBase
 		/** Bind a specific binding. */
-		virtual EBindResult BindSpecific(TSharedRef<DI::FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior) override;
+		virtual EBindResult BindSpecific(TRefCountPtr<DI::FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior) override;
+		/** Bind multiple bindings and notify subscribers and children in a single pass once all of them have been bound. */
+		virtual EBindResult BindSpecificMany(TConstArrayView<TRefCountPtr<DI::FBinding>> SpecificBindings, EBindConflictBehavior ConflictBehavior) override;
 		/** Find a binding by its ID. */
-		virtual TSharedPtr<DI::FBinding> FindBinding(const FBindingId& BindingId) const override;
+		virtual TRefCountPtr<DI::FBinding> FindBinding(const FBindingId& BindingId) const override;
+		/** Find a binding by the packed key of its ID. */
+		virtual TRefCountPtr<DI::FBinding> FindBinding(const FBindingKey& BindingKey) const override;
+		/** Find a binding in this container or its ancestors without taking a reference. */
+		virtual const DI::FBinding* FindBindingRaw(const FBindingKey& BindingKey) const override;
+		/** Visit the binding with the given key in this container and all of its ancestors, nearest first. Every ancestor is visited once. */
+		virtual void ForEachBinding(const FBindingKey& BindingKey, TFunctionRef<void(const DI::FBinding&)> Visitor) const override;
+		/** Find multiple bindings while walking our ancestors only once. */
+		virtual void FindBindings(TConstArrayView<FBindingId> BindingIds, TArrayView<const DI::FBinding*> OutBindings) const override;
 
 		/**
-		 * Get the delegate that will be invoked a single time when the binding with the given ID is bound.
-		 * If the binding is already bound the event will never fire.
+		 * Register a callback that will be invoked a single time when the binding with the given ID is bound.
+		 * If the binding is already bound the callback will never be invoked.
 		 * @param BindingId the ID of the binding to be notified about.
+		 * @param Callback the callback to invoke with the binding.
+		 * @param WaitingObject (Optional) the callback is dropped without being invoked once this object has been destroyed.
+		 * @return the handle to unsubscribe with.
 		 */
-		virtual FBindingSubscriptionList::FOnInstanceBound& Subscribe(const FBindingId& BindingId) const override;
+		virtual FBindingSubscriptionHandle Subscribe(const FBindingId& BindingId, FBindingSubscriptionList::FOnInstanceBound&& Callback, const UObject* WaitingObject) const override;
 		// --
 
 		/**
 		 * Unsubscribe from being notified about a binding.
 		 * @param BindingId The ID of the binding where there is a subscription
-		 * @param DelegateHandle The handle that was returned when the subscription was created
+		 * @param Handle The handle that was returned when the subscription was created
 		 * @return true if there was a subscription and it has been successfully removed.
 		 */
-		bool Unsubscribe(const FBindingId& BindingId, FDelegateHandle DelegateHandle) const;
+		bool Unsubscribe(const FBindingId& BindingId, FBindingSubscriptionHandle Handle) const;
 
 	private:
 		// - FConnectedDiContainer
 		virtual bool TryConnectSubcontainer(TSharedRef<FConnectedDiContainer> ConnectedDiContainer) override;
 		virtual bool TryDisconnectSubcontainer(TSharedRef<FConnectedDiContainer> ConnectedDiContainer) override;
-		virtual void NotifyInstanceBound(const DI::FBinding& NewBinding) const override;
-		virtual void RetryAllPendingWaits() const override;
-		virtual TSharedPtr<DI::FBinding> FindConnectedBinding(const DI::FBindingId& BindingId) const override;
+		virtual void NotifyInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) const override;
+		virtual TConstArrayView<FLookupTable> GetLookupTables() const override;
+		virtual void RebuildAncestorCaches() const override;
+		virtual void AddSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const override;
+		virtual void RemoveSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const override;
+		virtual const FPendingKeyIndex& GetSubtreePendingKeys() const override;
 		// --
 
+		// - FDiContainerBase
+		virtual void RemoveInvalidBindings() override;
+		virtual void RemoveAbandonedWaiters(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks) override;
+		virtual void DeliverInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) override;
+		// --
+
+		/** @return true if binds are currently rejected because the container is frozen. Logs an error for the given binding. */
+		bool RejectBindIfFrozen(const FBindingId& BindingId) const;
+		/** @return the binding that is bound for the ID now, i.e. the merged set for sets, or nullptr if it is in conflict with an existing binding. */
+		DI::FBinding* TryAddBinding(const TRefCountPtr<DI::FBinding>& SpecificBinding, EBindConflictBehavior ConflictBehavior);
+		/** Update the frozen table and the caches of our children after bindings have been added. */
+		void OnBindingsAdded();
+		/** @return the table that lookups in this container should use right now. */
+		FLookupTable GetOwnLookupTable() const;
+		/** Discard the resolve cache and recombine the ancestor filter if the generation of any of our ancestors has changed. */
+		void RefreshAncestorCaches() const;
+		/** Notify our own subscribers and update the pending key index of our subtree accordingly. */
+		void NotifySubscribers(TConstArrayView<const DI::FBinding*> NewBindings) const;
+
 		/** Our own registered Bindings */
-		TMap<FBindingId, TSharedRef<DI::FBinding>> Bindings = {};
+		FBindingTable Bindings = {};
+
+		/** Perfect hashed copy of Bindings that is used for lookups while frozen. Bindings stays the source of truth. */
+		FFrozenBindingTable FrozenBindings = {};
+		bool bIsFrozen = false;
+		EFrozenBindBehavior FrozenBindBehavior = EFrozenBindBehavior::Reject;
 
 		// mutable so we can use it in const resolve methods
 		mutable FBindingSubscriptionList Subscriptions;
 
+		/** Keys of all pending subscriptions in this container and its descendants, counted once for us and once per child. */
+		mutable FPendingKeyIndex SubtreePendingKeys = {};
+
+		/** Keys of all bindings that have ever been added to this container. */
+		FBindingBloomFilter BindingFilter = {};
+		/** Bumped whenever our own bindings change. Our descendants compare it through our lookup table. */
+		uint64 BindingGeneration = 0;
+
+		static constexpr uint64 InvalidCacheGeneration = MAX_uint64;
+
+		/** Bindings that have been resolved from ancestors. Only valid while AncestorCacheGeneration matches the generations of our ancestors. */
+		mutable FBindingResolveCache ResolveCache = {};
+		/**
+		 * Union of the binding filters of all ancestors. Lookups for keys outside of it skip the parent chain.
+		 * Only valid while AncestorCacheGeneration matches the generations of our ancestors, so binds don't have to update all descendants.
+		 */
+		mutable FBindingBloomFilter AncestorBindingFilter = {};
+		/** Sum of the generations of our ancestors when the caches were last refreshed. */
+		mutable uint64 AncestorCacheGeneration = InvalidCacheGeneration;
+
+		/** Our own table followed by the lookup tables of our parent. */
+		mutable FLookupTableArray LookupTables;
+
 		TWeakPtr<FConnectedDiContainer> ParentContainer;
 
 		// Mutable so we can clean up invalid children in getters
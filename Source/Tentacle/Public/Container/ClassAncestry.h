@@ -0,0 +1,38 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TypeId.h"
+
+namespace DI
+{
+	/**
+	 * Precomputed table of all types a UClass can be resolved as.
+	 * Used by polymorphic bindings to index a binding under all of its ancestors at bind time,
+	 * so resolving via a parent class or an interface is a single lookup instead of a walk over the class hierarchy.
+	 */
+	struct TENTACLE_API FClassAncestry
+	{
+		struct FInterface
+		{
+			FTypeId TypeId;
+			UClass* Class = nullptr;
+
+			/** Index of the least derived class in SuperClasses that implements the interface. */
+			int32 SuperClassIndex = INDEX_NONE;
+		};
+
+		/** The class itself and all of its super classes up to, but not including, UObject. Most derived first. */
+		TArray<FTypeId> SuperClasses;
+
+		/** All interfaces that are implemented by the class or any of its super classes, including the interfaces they inherit from. */
+		TArray<FInterface> Interfaces;
+
+		/**
+		 * Get the ancestry of a class.
+		 * Computed once per class and cached for the rest of the session.
+		 */
+		static const FClassAncestry& Get(UClass* Class);
+	};
+}
@@ -0,0 +1,172 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BindConflictBehavior.h"
+#include "BindingHelper.h"
+#include "BindingSubscriptionList.h"
+#include "BindResult.h"
+#include "Binding.h"
+#include "BindingId.h"
+#include "BindingTable.h"
+#include "DiContainerBase.h"
+#include "DiContainerConcept.h"
+#include "FrozenBindingTable.h"
+#include "Injector.h"
+#include "ResolveHelper.h"
+#include "HAL/PlatformTLS.h"
+#include <atomic>
+
+namespace DI
+{
+	/**
+	 * Di Container that can be resolved from any thread.
+	 *
+	 * Readers look up bindings in an immutable snapshot that is published through an atomic pointer and never take a lock.
+	 * Writers are serialized, rebuild the snapshot and publish it. The previous snapshot is deleted once all readers that
+	 * might still see it have left, which is tracked with two epochs of striped reader counters.
+	 *
+	 * Binding is possible from any thread but is a lot more expensive than in FDiContainer, so this container is meant for
+	 * services that are bound once and resolved often.
+	 * Bindings can be replaced and deleted on another thread right after a lookup, so resolving a UStruct returns a copy instead of a
+	 * reference into the binding (see TResolveHelper::TResolveInstPtr). Use TryGetUStructView to read big structs without copying them,
+	 * the view keeps the binding alive.
+	 * Subscribing (i.e. waiting for bindings) is only supported on the game thread and subscribers are always notified on the game thread.
+	 * Deferred notifications are queued once the game thread picks them up.
+	 * Has to be created with MakeShared so notifications of bindings from other threads can be forwarded to the game thread.
+	 */
+	class TENTACLE_API FConcurrentDiContainer final : public FDiContainerBase, public TSharedFromThis<FConcurrentDiContainer>
+	{
+	public:
+		FConcurrentDiContainer();
+		virtual ~FConcurrentDiContainer() override;
+
+		FConcurrentDiContainer(const FConcurrentDiContainer&) = delete;
+		FConcurrentDiContainer& operator=(const FConcurrentDiContainer&) = delete;
+
+		/** Bindings may be replaced while others resolve, so resolves always take a reference. See DiContainerWithConcurrentWritersConcept. */
+		static constexpr bool bAllowsConcurrentWriters = true;
+
+		// - DiContainerConcept
+		/** Bind a specific binding. Thread safe. */
+		virtual EBindResult BindSpecific(TRefCountPtr<DI::FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior) override;
+		/** Bind multiple bindings and publish them together. Thread safe. */
+		virtual EBindResult BindSpecificMany(TConstArrayView<TRefCountPtr<DI::FBinding>> SpecificBindings, EBindConflictBehavior ConflictBehavior) override;
+
+		/** Find a binding by its ID. Thread safe and lock free. */
+		virtual TRefCountPtr<DI::FBinding> FindBinding(const FBindingId& BindingId) const override;
+		/** Find a binding by the packed key of its ID. Thread safe and lock free. The reference is taken before the snapshot can be deleted. */
+		virtual TRefCountPtr<DI::FBinding> FindBinding(const FBindingKey& BindingKey) const override;
+		/**
+		 * Find a binding without taking a reference. Lock free.
+		 * Nothing keeps the binding alive once this returns, so it is only safe while no other thread binds and before the next garbage collection.
+		 * Resolves never use this, use FindBinding instead.
+		 */
+		virtual const DI::FBinding* FindBindingRaw(const FBindingKey& BindingKey) const override;
+		/** Visit the binding with the given key while holding a reference to it. Thread safe and lock free. */
+		virtual void ForEachBinding(const FBindingKey& BindingKey, TFunctionRef<void(const DI::FBinding&)> Visitor) const override;
+
+		/**
+		 * Register a callback that will be invoked a single time when the binding with the given ID is bound.
+		 * If the binding is already bound the callback will never be invoked.
+		 * Game thread only.
+		 * @param BindingId the ID of the binding to be notified about.
+		 * @param Callback the callback to invoke with the binding.
+		 * @param WaitingObject (Optional) the callback is dropped without being invoked once this object has been destroyed.
+		 * @return the handle to unsubscribe with.
+		 */
+		virtual FBindingSubscriptionHandle Subscribe(const FBindingId& BindingId, FBindingSubscriptionList::FOnInstanceBound&& Callback, const UObject* WaitingObject) const override;
+		// --
+
+		/**
+		 * Unsubscribe from being notified about a binding.
+		 * Game thread only.
+		 * @param BindingId The ID of the binding where there is a subscription
+		 * @param Handle The handle that was returned when the subscription was created
+		 * @return true if there was a subscription and it has been successfully removed.
+		 */
+		bool Unsubscribe(const FBindingId& BindingId, FBindingSubscriptionHandle Handle) const;
+
+		/** Call this from the owning type to prevent types and bindings to be garbage collected. */
+		void AddReferencedObjects(FReferenceCollector& Collector);
+
+		/** Get the Binding API */
+		TBindingHelper<FConcurrentDiContainer> Bind();
+		/** Get the Resolving API */
+		TResolveHelper<FConcurrentDiContainer> Resolve() const;
+		/** Get the Injection API */
+		TInjector<FConcurrentDiContainer> Inject();
+
+	private:
+		static constexpr int32 NumReaderStripes = 16;
+
+		/** Readers that are currently looking at a snapshot, per epoch. On its own cache line so readers on different threads do not contend. */
+		struct alignas(PLATFORM_CACHE_LINE_SIZE) FReaderStripe
+		{
+			std::atomic<int32> NumReaders[2] = {};
+		};
+
+		virtual void RemoveInvalidBindings() override;
+		virtual void RemoveAbandonedWaiters(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks) override;
+		virtual void DeliverInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) override;
+
+		/** @return the binding that is bound for the ID now, i.e. the merged set for sets, or nullptr if it is in conflict with an existing binding. Requires WriteLock. */
+		DI::FBinding* TryAddBinding(const TRefCountPtr<DI::FBinding>& SpecificBinding, EBindConflictBehavior ConflictBehavior);
+
+		/** Publish a new snapshot of Bindings and delete the old one once no reader can see it anymore. Requires WriteLock. */
+		void PublishBindings();
+
+		/** Wait until all readers that have entered before this call have left. Requires WriteLock. */
+		void WaitForReaders();
+
+		/**
+		 * Register as reader and call the functor with the current snapshot.
+		 * The snapshot and everything it references stay alive until the functor returns, take a reference to keep a binding beyond that.
+		 */
+		template <class TFunctor>
+		auto ReadSnapshot(TFunctor&& Functor) const
+		{
+			FReaderStripe& ReaderStripe = ReaderStripes[FPlatformTLS::GetCurrentThreadId() % NumReaderStripes];
+
+			// Register as reader of the current epoch. If a writer flipped the epoch in between, it might not wait for us, so try again.
+			uint32 Epoch = ReadEpoch.load();
+			ReaderStripe.NumReaders[Epoch & 1].fetch_add(1);
+			while (ReadEpoch.load() != Epoch)
+			{
+				ReaderStripe.NumReaders[Epoch & 1].fetch_sub(1);
+				Epoch = ReadEpoch.load();
+				ReaderStripe.NumReaders[Epoch & 1].fetch_add(1);
+			}
+
+			auto Result = Functor(*PublishedBindings.load(std::memory_order_acquire));
+
+			ReaderStripe.NumReaders[Epoch & 1].fetch_sub(1, std::memory_order_release);
+			return Result;
+		}
+
+		/** Notify subscribers on the game thread. */
+		void NotifyInstancesBound(TArray<TRefCountPtr<DI::FBinding>> NewBindings);
+
+		/** Serializes all writers. */
+		FCriticalSection WriteLock;
+
+		/** Source of truth for the bindings. Only accessed by writers. */
+		FBindingTable Bindings = {};
+
+		/** Snapshot of Bindings that readers look at. */
+		std::atomic<FFrozenBindingTable*> PublishedBindings;
+
+		/** Readers register in the stripe of their thread with the parity of the current epoch. */
+		mutable FReaderStripe ReaderStripes[NumReaderStripes];
+		std::atomic<uint32> ReadEpoch = 0;
+
+		mutable FBindingSubscriptionList Subscriptions;
+	};
+
+	static_assert(TModels<CDiContainer, FConcurrentDiContainer>::Value);
+	static_assert(TModels<CTypeHasBindSpecific, FConcurrentDiContainer>::Value);
+	static_assert(TModels<CTypeHasFindBinding, FConcurrentDiContainer>::Value);
+	static_assert(TModels<CTypeHasSubscribe, FConcurrentDiContainer>::Value);
+	static_assert(DiContainerConcept<FConcurrentDiContainer>);
+}
@@ -9,6 +9,7 @@
 #include "BindResult.h"
 #include "Binding.h"
 #include "BindingId.h"
+#include "BindingTable.h"
 #include "DiContainerBase.h"
 #include "DiContainerConcept.h"
 #include "Injector.h"
@@ -24,26 +25,35 @@ namespace DI
 	public:
 		// - DiContainerConcept
 		/** Bind a specific binding. */
-		virtual EBindResult BindSpecific(TSharedRef<DI::FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior) override;
+		virtual EBindResult BindSpecific(TRefCountPtr<DI::FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior) override;
+		/** Bind multiple bindings and notify subscribers once all of them have been bound. */
+		virtual EBindResult BindSpecificMany(TConstArrayView<TRefCountPtr<DI::FBinding>> SpecificBindings, EBindConflictBehavior ConflictBehavior) override;
 
 		/** Find a binding by its ID. */
-		virtual TSharedPtr<DI::FBinding> FindBinding(const FBindingId& BindingId) const override;
+		virtual TRefCountPtr<DI::FBinding> FindBinding(const FBindingId& BindingId) const override;
+		/** Find a binding by the packed key of its ID. */
+		virtual TRefCountPtr<DI::FBinding> FindBinding(const FBindingKey& BindingKey) const override;
+		/** Find a binding without taking a reference. Bindings of destroyed UObjects are found until the next garbage collection removes them. */
+		virtual const DI::FBinding* FindBindingRaw(const FBindingKey& BindingKey) const override;
 
 		/**
-		 * Get the delegate that will be invoked a single time when the binding with the given ID is bound.
-		 * If the binding is already bound the event will never fire.
+		 * Register a callback that will be invoked a single time when the binding with the given ID is bound.
+		 * If the binding is already bound the callback will never be invoked.
 		 * @param BindingId the ID of the binding to be notified about.
+		 * @param Callback the callback to invoke with the binding.
+		 * @param WaitingObject (Optional) the callback is dropped without being invoked once this object has been destroyed.
+		 * @return the handle to unsubscribe with.
 		 */
-		virtual FBindingSubscriptionList::FOnInstanceBound& Subscribe(const FBindingId& BindingId) const override;
+		virtual FBindingSubscriptionHandle Subscribe(const FBindingId& BindingId, FBindingSubscriptionList::FOnInstanceBound&& Callback, const UObject* WaitingObject) const override;
 		// --
 
 		/**
 		 * Unsubscribe from being notified about a binding.
 		 * @param BindingId The ID of the binding where there is a subscription
-		 * @param DelegateHandle The handle that was returned when the subscription was created
+		 * @param Handle The handle that was returned when the subscription was created
 		 * @return true if there was a subscription and it has been successfully removed.
 		 */
-		bool Unsubscribe(const FBindingId& BindingId, FDelegateHandle DelegateHandle) const;
+		bool Unsubscribe(const FBindingId& BindingId, FBindingSubscriptionHandle Handle) const;
 
 		/** Call this from the owning type to prevent types and bindings to be garbage collected. */
 		void AddReferencedObjects(FReferenceCollector& Collector);
@@ -55,7 +65,14 @@ namespace DI
 		/** Get the Injection API */
 		TInjector<FDiContainer> Inject();
 	protected:
-		TMap<FBindingId, TSharedRef<DI::FBinding>> Bindings = {};
+		virtual void RemoveInvalidBindings() override;
+		virtual void RemoveAbandonedWaiters(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks) override;
+		virtual void DeliverInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) override;
+
+		/** @return the binding that is bound for the ID now, i.e. the merged set for sets, or nullptr if it is in conflict with an existing binding. */
+		DI::FBinding* TryAddBinding(const TRefCountPtr<DI::FBinding>& SpecificBinding, EBindConflictBehavior ConflictBehavior);
+
+		FBindingTable Bindings = {};
 		mutable FBindingSubscriptionList Subscriptions;
 	};
 
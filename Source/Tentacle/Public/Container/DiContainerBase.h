@@ -5,7 +5,14 @@
 #include "CoreMinimal.h"
 #include "BindConflictBehavior.h"
 #include "BindResult.h"
+#include "BindingNotificationMode.h"
+#include "BindingArena.h"
+#include "BindingBloomFilter.h"
+#include "BindingSubscriptionList.h"
+#include "BindingTable.h"
+#include "FrozenBindingTable.h"
 #include "DiContainerConcept.h"
+#include <atomic>
 
 namespace DI
 {
@@ -15,25 +22,201 @@ namespace DI
 	class TENTACLE_API FDiContainerBase
 	{
 	public:
-		FDiContainerBase() = default;
-		virtual ~FDiContainerBase() = default;
+		FDiContainerBase();
+		/** Copies share the arena of the original but register for sweeps after garbage collection on their own. */
+		FDiContainerBase(const FDiContainerBase& Other);
+		FDiContainerBase& operator=(const FDiContainerBase& Other);
+		virtual ~FDiContainerBase();
 
 
 		// - DiContainerConcept
 		/** Bind a specific binding. */
-		virtual EBindResult BindSpecific(TSharedRef<DI::FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior) = 0;
+		virtual EBindResult BindSpecific(TRefCountPtr<DI::FBinding> SpecificBinding, EBindConflictBehavior ConflictBehavior) = 0;
+		/**
+		 * Bind multiple bindings at once.
+		 * Implementations should insert all bindings before notifying any subscribers and notify them in a single pass.
+		 * @return Bound if all bindings have been bound, otherwise the result of the first binding that failed.
+		 */
+		virtual EBindResult BindSpecificMany(TConstArrayView<TRefCountPtr<DI::FBinding>> SpecificBindings, EBindConflictBehavior ConflictBehavior);
 		/** Find a binding by its ID. */
-		virtual TSharedPtr<DI::FBinding> FindBinding(const FBindingId& BindingId) const = 0;
+		virtual TRefCountPtr<DI::FBinding> FindBinding(const FBindingId& BindingId) const = 0;
+		/** Find a binding by the packed key of its ID. Prefer this if you already have a key to skip building the ID. */
+		virtual TRefCountPtr<DI::FBinding> FindBinding(const FBindingKey& BindingKey) const = 0;
+		/**
+		 * Find a binding without taking a reference to it.
+		 * The binding stays valid until it is replaced or its container is destroyed, so never hold on to it beyond the current frame.
+		 * Use this for synchronous resolves to avoid touching the reference count.
+		 * Bindings of destroyed UObjects are still found until the next garbage collection removes them.
+		 */
+		virtual const DI::FBinding* FindBindingRaw(const FBindingKey& BindingKey) const = 0;
+		/**
+		 * Find multiple bindings without taking references to them, see FindBindingRaw.
+		 * Connected containers walk their ancestors once for the whole batch instead of once per binding.
+		 * @param BindingIds - the IDs of the bindings to find.
+		 * @param OutBindings - receives the binding of the ID at the same index or nullptr if it is not bound. Must have as many elements as BindingIds.
+		 */
+		virtual void FindBindings(TConstArrayView<FBindingId> BindingIds, TArrayView<const DI::FBinding*> OutBindings) const;
+		/**
+		 * Visit the binding with the given key in this container and in all of its ancestors, nearest first.
+		 * Used for sets, which are resolved as the union of all sets along the chain.
+		 * Bindings are passed without taking a reference, see FindBindingRaw.
+		 */
+		virtual void ForEachBinding(const FBindingKey& BindingKey, TFunctionRef<void(const DI::FBinding&)> Visitor) const;
 
 		/**
-		 * Get the delegate that will be invoked a single time when the binding with the given ID is bound.
-		 * If the binding is already bound the event will never fire.
+		 * Register a callback that will be invoked a single time when the binding with the given ID is bound.
+		 * If the binding is already bound the callback will never be invoked.
 		 * @param BindingId the ID of the binding to be notified about.
+		 * @param Callback the callback to invoke with the binding.
+		 * @param WaitingObject (Optional) the callback is dropped without being invoked once this object has been destroyed.
+		 * @return the handle to unsubscribe with.
 		 */
-		virtual FBindingSubscriptionList::FOnInstanceBound& Subscribe(const FBindingId& BindingId) const = 0;
+		virtual FBindingSubscriptionHandle Subscribe(const FBindingId& BindingId, FBindingSubscriptionList::FOnInstanceBound&& Callback, const UObject* WaitingObject) const = 0;
 		// --
+
+		/** Get the arena that bindings for this container should be allocated from. Created on first use, so containers that never bind don't pay for it. */
+		FBindingArena* GetBindingArena() const
+		{
+			if (FBindingArena* Arena = BindingArena.load(std::memory_order_acquire))
+				return Arena;
+			return CreateBindingArena();
+		}
+
+		/**
+		 * Choose when subscribers are notified about bindings of this container.
+		 * Connected containers notify their whole subtree in a single pass when the queue is flushed.
+		 * Switching back to immediate notifications flushes the queue.
+		 * Game thread only.
+		 */
+		void SetNotificationMode(EBindingNotificationMode Mode);
+
+		FORCEINLINE EBindingNotificationMode GetNotificationMode() const
+		{
+			return NotificationMode;
+		}
+
+		/**
+		 * Notify subscribers about all bindings that have been queued in deferred mode.
+		 * Happens automatically at the end of the frame. Game thread only.
+		 */
+		void FlushNotifications();
+
+		/**
+		 * Hook the sweep of all containers that need it into garbage collection.
+		 * Called by the module, so containers never touch the garbage collection delegates themselves.
+		 */
+		static void StartGarbageCollectionSweeps();
+		static void StopGarbageCollectionSweeps();
+
+	protected:
+		/**
+		 * Remove all bindings that have become invalid.
+		 * Called after every garbage collection if any binding that can expire has been bound,
+		 * so lookups can trust that every binding they find is valid.
+		 */
+		virtual void RemoveInvalidBindings()
+		{
+		}
+
+		/**
+		 * Called after every garbage collection to drop subscriptions of waiting objects that have been destroyed,
+		 * so their futures are canceled and their memory is released even if the binding never arrives.
+		 * @param OutAbandonedCallbacks - receives the callbacks of the dropped subscriptions. They are destroyed once the sweep of this container is done,
+		 *        because they may hold the last reference to it.
+		 */
+		virtual void RemoveAbandonedWaiters(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks)
+		{
+		}
+
+		/**
+		 * Make sure that RemoveInvalidBindings and RemoveAbandonedWaiters are called after every garbage collection from now on.
+		 * Containers register the first time they need it, so idle containers cost nothing during garbage collection.
+		 * Thread safe.
+		 */
+		void EnsureSweptAfterGarbageCollection() const;
+
+		/**
+		 * Remove all bindings from a table of this container that have become invalid.
+		 * @return the number of removed bindings.
+		 */
+		static int32 RemoveInvalidBindingsFromTable(FBindingTable& Table);
+
+		/**
+		 * Add a binding to a table of this container.
+		 * Sets are appended to an already bound set, other bindings are in conflict with valid bindings of the same ID.
+		 * @param bCopyOnWrite - append to a copy of a bound set instead of the set itself, for containers whose bound sets may be read concurrently.
+		 * @return the binding that is bound for the ID now, which is the merged set for sets and subscribers have to be notified with,
+		 *         or nullptr if the binding is in conflict with an existing binding.
+		 */
+		DI::FBinding* TryAddBindingToTable(
+			FBindingTable& Table,
+			const TRefCountPtr<DI::FBinding>& SpecificBinding,
+			EBindConflictBehavior ConflictBehavior,
+			bool bCopyOnWrite = false);
+
+		/** Notify subscribers about new bindings right away or queue them, depending on the notification mode. */
+		void DispatchInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings);
+
+		/** Notify all subscribers that wait for the new bindings. */
+		virtual void DeliverInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) = 0;
+
+	private:
+		void OnPostGarbageCollect(TArray<FBindingSubscriptionList::FOnInstanceBound>& OutAbandonedCallbacks);
+
+		/** Call OnPostGarbageCollect on every registered container. */
+		static void SweepAfterGarbageCollection();
+
+		/** Create our arena, or return the one that another thread has created in the meantime. */
+		FBindingArena* CreateBindingArena() const;
+
+		/** Intrusive list of the containers that are swept after garbage collection. Guarded by the lock of the list. */
+		mutable FDiContainerBase* PrevSweptContainer = nullptr;
+		mutable FDiContainerBase* NextSweptContainer = nullptr;
+		mutable std::atomic<bool> bIsSweptAfterGarbageCollection = false;
+
+		EBindingNotificationMode NotificationMode = EBindingNotificationMode::Immediate;
+		/** Bindings that have been bound in deferred mode since the last flush, in bind order. */
+		TArray<TRefCountPtr<DI::FBinding>> QueuedNotifications;
+		/** Only registered while there are queued notifications. */
+		FDelegateHandle EndFrameHandle;
+
+		/** Only containers that ever had a binding that can expire have to be swept after garbage collection. */
+		bool bHasExpirableBindings = false;
+
+		/**
+		 * Pool for our bindings, holding a reference. Reference counted so bindings that outlive us keep their memory.
+		 * Atomic because concurrent containers may create bindings on multiple threads at once.
+		 */
+		mutable std::atomic<FBindingArena*> BindingArena = nullptr;
 	};
 
+	/**
+	 * Bindings of a connected container as seen from its descendants.
+	 * Points to the frozen table while the container is frozen, so lookups always take the fastest path.
+	 */
+	struct FLookupTable
+	{
+		const FBindingTable* Table = nullptr;
+		const FFrozenBindingTable* FrozenTable = nullptr;
+		/** Keys of all bindings that have ever been added to Table. */
+		const FBindingBloomFilter* Filter = nullptr;
+		/** Bumped whenever bindings are added to or removed from Table, so descendants know when to discard their resolve caches. */
+		const uint64* Generation = nullptr;
+
+		FORCEINLINE const TRefCountPtr<DI::FBinding>* Find(const FBindingKey& Key) const
+		{
+			return FrozenTable ? FrozenTable->Find(Key) : Table->Find(Key);
+		}
+
+		FORCEINLINE bool operator==(const FLookupTable& Other) const
+		{
+			return Table == Other.Table;
+		}
+	};
+
+	/** Flattened lookup tables of a container and all of its ancestors, in lookup order. */
+	using FLookupTableArray = TArray<FLookupTable, TInlineAllocator<8>>;
+
 	/**
 	 * Virtual base so we can abstract over DiContainers
 	 */
@@ -46,7 +229,7 @@ namespace DI
 		/**
 		 * @return true if the connection has been established successfully, false otherwise.
 		 * @note Implementers should log an error with further information.
-		 * @note The parent should call RetryAllPendingWaits if there are already any instances bound. 
+		 * @note The parent should call RetryPendingWaits with its lookup tables, so waits for bindings that are already bound are fulfilled.
 		 */
 		virtual bool TryConnectSubcontainer(TSharedRef<FConnectedDiContainer> ConnectedDiContainer) = 0;
 
@@ -55,23 +238,62 @@ namespace DI
 		 * @note Implementers should log an error with further information.
 		 */
 		virtual bool TryDisconnectSubcontainer(TSharedRef<FConnectedDiContainer> ConnectedDiContainer) = 0;
+		/**
+		 * Notifies this connected container that new bindings have been bound in the parent container.
+		 * Implementations should notify their children with all bindings at once so the hierarchy is walked only once
+		 * and skip children that do not wait for any of the bindings.
+		 * @param NewBindings - the new bindings
+		 */
+		virtual void NotifyInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) const = 0;
+
 		/**
 		 * Notifies this connected container that a new binding has been bound in the parent container.
 		 * @param NewBinding - the new binding
 		 */
-		virtual void NotifyInstanceBound(const DI::FBinding& NewBinding) const = 0;
+		void NotifyInstanceBound(const DI::FBinding& NewBinding) const
+		{
+			const DI::FBinding* NewBindingPtr = &NewBinding;
+			NotifyInstancesBound(MakeArrayView(&NewBindingPtr, 1));
+		}
 
 		/**
-		 * Requests this container to reevaluate all pending bindings in case they have become available through adding a parent container.
+		 * Fulfill the pending waits of this container and its subtree for bindings that have become reachable through a new parent.
+		 * Only the pending keys of the subtree are looked up in the new tables and only branches with matches are notified,
+		 * so the cost is independent of the size of the subtree.
+		 * Waiting containers are only notified with bindings that they resolve themselves, so bindings of the subtree
+		 * whose deferred notifications are still queued are not overridden by those of the new ancestors.
 		 * After this operation the container and its children should not have any more pending waits for already bound bindings.
+		 * @param NewAncestorTables - the lookup tables of the new parent
+		 */
+		void RetryPendingWaits(TConstArrayView<FLookupTable> NewAncestorTables) const;
+
+		/**
+		 * Get the tables of this container and all of its ancestors in lookup order, i.e. nearest and highest priority first.
+		 * Every table is contained only once, even if it is reachable through multiple parents of a forking container.
+		 * Descendants loop over these directly instead of walking the chain.
+		 * The tables stay valid until RebuildAncestorCaches is called, which happens whenever an ancestor is connected, disconnected or destroyed.
+		 */
+		virtual TConstArrayView<FLookupTable> GetLookupTables() const = 0;
+
+		/**
+		 * Rebuild the lookup tables from our own bindings and those of our parents and propagate them to all children.
+		 * Has to be called whenever the parents of this container change or one of them is destroyed.
 		 */
-		virtual void RetryAllPendingWaits() const = 0;
+		virtual void RebuildAncestorCaches() const = 0;
 
 		/**
-		 * Try to find a binding in this container.
-		 * @param BindingId - the binding to look for
-		 * @return the binding if it has been found, nullptr otherwise.
+		 * Register binding keys that have become pending in this container or in the subtree of one of its children.
+		 * Keys that were not pending in our subtree before are forwarded to our parents, so every ancestor knows which keys its subtree waits for.
 		 */
-		virtual TSharedPtr<DI::FBinding> FindConnectedBinding(const DI::FBindingId& BindingId) const = 0;
+		virtual void AddSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const = 0;
+
+		/**
+		 * Unregister binding keys that are not pending in this container or in the subtree of one of its children anymore.
+		 * Must be balanced with AddSubtreePendingKeys.
+		 */
+		virtual void RemoveSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const = 0;
+
+		/** Get the keys of all pending subscriptions in this container and its descendants. */
+		virtual const FPendingKeyIndex& GetSubtreePendingKeys() const = 0;
 	};
 }
@@ -12,7 +12,7 @@ namespace DI
 	{
 		template <class TDiContainer>
 		auto Requires(TDiContainer& DiContainer,
-		              TSharedRef<DI::FBinding> SpecificBinding,
+		              TRefCountPtr<DI::FBinding> SpecificBinding,
 		              EBindConflictBehavior ConflictBehavior) -> decltype(
 			DiContainer.BindSpecific(SpecificBinding, ConflictBehavior)
 		);
@@ -31,8 +31,9 @@ namespace DI
 	{
 		template <class TDiContainer>
 		auto Requires(const TDiContainer& DiContainer,
-		              const FBindingId& BindingId) -> decltype(
-			DiContainer.Subscribe(BindingId)
+		              const FBindingId& BindingId,
+		              FBindingSubscriptionList::FOnInstanceBound&& Callback) -> decltype(
+			DiContainer.Subscribe(BindingId, MoveTemp(Callback), nullptr)
 		);
 	};
 
@@ -62,8 +63,40 @@ namespace DI
 	template <class T>
 	concept DiContainerConcept = requires(T DiContainer)
 	{
-		{ DiContainer.BindSpecific(DeclVal<TSharedRef<DI::FBinding>>(), DeclVal<EBindConflictBehavior>()) } -> Private::convertible_to<EBindResult>;
-		{ DiContainer.FindBinding(DeclVal<const FBindingId&>()) } -> Private::convertible_to<TSharedPtr<DI::FBinding>>;
-		{ DiContainer.Subscribe(DeclVal<const FBindingId&>()) } -> Private::convertible_to<FBindingSubscriptionList::FOnInstanceBound&>;
+		{ DiContainer.BindSpecific(DeclVal<TRefCountPtr<DI::FBinding>>(), DeclVal<EBindConflictBehavior>()) } -> Private::convertible_to<EBindResult>;
+		{ DiContainer.FindBinding(DeclVal<const FBindingId&>()) } -> Private::convertible_to<TRefCountPtr<DI::FBinding>>;
+		{ DiContainer.Subscribe(DeclVal<const FBindingId&>(), DeclVal<FBindingSubscriptionList::FOnInstanceBound>(), DeclVal<const UObject*>()) } -> Private::convertible_to<FBindingSubscriptionHandle>;
+	};
+
+	/** Optional extension of DiContainerConcept for containers that can look up bindings by their packed key. */
+	template <class T>
+	concept DiContainerWithKeyLookupConcept = requires(const T& DiContainer)
+	{
+		{ DiContainer.FindBinding(DeclVal<const FBindingKey&>()) } -> Private::convertible_to<TRefCountPtr<DI::FBinding>>;
+	};
+
+	/**
+	 * Containers whose bindings can be replaced or removed while others resolve.
+	 * Opt in with a static constexpr bool bAllowsConcurrentWriters = true.
+	 * Raw lookups are never safe for them, because nothing keeps the binding alive once the lookup has returned.
+	 */
+	template <class T>
+	concept DiContainerWithConcurrentWritersConcept = requires
+	{
+		requires T::bAllowsConcurrentWriters;
+	};
+
+	/** Optional extension of DiContainerConcept for containers that can look up bindings without taking a reference. */
+	template <class T>
+	concept DiContainerWithRawLookupConcept = !DiContainerWithConcurrentWritersConcept<T> && requires(const T& DiContainer)
+	{
+		{ DiContainer.FindBindingRaw(DeclVal<const FBindingKey&>()) } -> Private::convertible_to<const DI::FBinding*>;
+	};
+
+	/** Optional extension of DiContainerConcept for containers that can look up multiple bindings in a single pass without taking references. */
+	template <class T>
+	concept DiContainerWithBatchLookupConcept = !DiContainerWithConcurrentWritersConcept<T> && requires(const T& DiContainer)
+	{
+		DiContainer.FindBindings(DeclVal<TConstArrayView<FBindingId>>(), DeclVal<TArrayView<const DI::FBinding*>>());
 	};
 }
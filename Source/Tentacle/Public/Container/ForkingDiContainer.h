@@ -25,7 +25,7 @@ namespace DI
 		// Technically, we could have a copy constructor, but copying is usually a user error, so we delete it to catch these cases earlier.
 		FForkingDiContainer(const FForkingDiContainer&) = delete;
 
-		virtual ~FForkingDiContainer() override = default;
+		virtual ~FForkingDiContainer() override;
 
 		/**
 		 * Add a parent to the chain.
@@ -44,18 +44,33 @@ namespace DI
 		// - FConnectedDiContainer
 		virtual bool TryConnectSubcontainer(TSharedRef<FConnectedDiContainer> ConnectedDiContainer) override;
 		virtual bool TryDisconnectSubcontainer(TSharedRef<FConnectedDiContainer> ConnectedDiContainer) override;
-		virtual void NotifyInstanceBound(const DI::FBinding& NewBinding) const override;
-		virtual void RetryAllPendingWaits() const override;
-		virtual TSharedPtr<DI::FBinding> FindConnectedBinding(const DI::FBindingId& BindingId) const override;
+		virtual void NotifyInstancesBound(TConstArrayView<const DI::FBinding*> NewBindings) const override;
+		virtual TConstArrayView<FLookupTable> GetLookupTables() const override;
+		virtual void RebuildAncestorCaches() const override;
+		virtual void AddSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const override;
+		virtual void RemoveSubtreePendingKeys(TConstArrayView<FBindingKey> BindingKeys) const override;
+		virtual const FPendingKeyIndex& GetSubtreePendingKeys() const override;
 		// --
 
+		struct FParentContainer
+		{
+			int32 Priority;
+			TWeakPtr<FConnectedDiContainer> WeakContainer;
+		};
+
 		/**
 		 * Higher priority containers will be checked first.
 		 * mutable so we can use clear up dead parents in const methods
 		 */
-		mutable TArray<TPair<int32, TWeakPtr<FConnectedDiContainer>>, TInlineAllocator<4>> ParentContainers;
+		mutable TArray<FParentContainer, TInlineAllocator<4>> ParentContainers;
 
 		// Mutable so we can clean up invalid children in getters
 		mutable TArray<TWeakPtr<FConnectedDiContainer>, TInlineAllocator<1>> ChildrenContainers;
+
+		/** Keys of all pending subscriptions in the subtrees of our children, counted once per child. */
+		mutable FPendingKeyIndex SubtreePendingKeys = {};
+
+		/** Lookup tables of all parents in priority order. Ancestors that are shared by multiple parents are only contained once. */
+		mutable FLookupTableArray LookupTables;
 	};
 }
@@ -0,0 +1,78 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BindingTable.h"
+
+namespace DI
+{
+	/**
+	 * Immutable snapshot of a binding table that uses a perfect hash function built with hash and displace.
+	 *
+	 * Keys are distributed into small buckets and every bucket stores a displacement that has been chosen at build time
+	 * so that all keys of all buckets end up in distinct slots.
+	 * Buckets use the cached hash of the key while slots use a hash of the whole key seeded by the displacement,
+	 * so keys whose cached hashes collide still end up in different slots.
+	 * A lookup reads the displacement of its bucket and then compares exactly one slot, so the worst case is the same as the best case.
+	 * Displacements and slots live in a single allocation.
+	 */
+	class TENTACLE_API FFrozenBindingTable
+	{
+	public:
+		using FSlot = FBindingTable::FSlot;
+
+		FFrozenBindingTable() = default;
+		explicit FFrozenBindingTable(const FBindingTable& BindingTable);
+		~FFrozenBindingTable();
+
+		FFrozenBindingTable(const FFrozenBindingTable&) = delete;
+		FFrozenBindingTable& operator=(const FFrozenBindingTable&) = delete;
+		FFrozenBindingTable(FFrozenBindingTable&& Other);
+		FFrozenBindingTable& operator=(FFrozenBindingTable&& Other);
+
+		/** Find the binding for the given key. */
+		const TRefCountPtr<DI::FBinding>* Find(const FBindingKey& Key) const
+		{
+			if (NumSlots == 0)
+				return nullptr;
+
+			const uint32 Displacement = Displacements[GetBucketIndex(Key.GetHash(), NumBuckets)];
+			const FSlot& Slot = Slots[GetSlotIndex(Key, Displacement, NumSlots)];
+			return Slot.Key == Key && Slot.Binding.IsValid() ? &Slot.Binding : nullptr;
+		}
+
+		FORCEINLINE int32 Num() const
+		{
+			return NumBindings;
+		}
+
+	private:
+		/** Map a 32 bit value onto [0, Range) without a division. */
+		static FORCEINLINE uint32 ReduceRange(uint32 Value, uint32 Range)
+		{
+			return static_cast<uint32>((static_cast<uint64>(Value) * Range) >> 32);
+		}
+
+		static FORCEINLINE uint32 GetBucketIndex(uint32 Hash, uint32 InNumBuckets)
+		{
+			return ReduceRange(Hash, InNumBuckets);
+		}
+
+		static FORCEINLINE uint32 GetSlotIndex(const FBindingKey& Key, uint32 Displacement, uint32 InNumSlots)
+		{
+			return ReduceRange(Key.GetSeededHash(Displacement), InNumSlots);
+		}
+
+		void Build(const FBindingTable& BindingTable);
+		void Release();
+
+		/** Single allocation that holds the slots followed by the displacements. */
+		void* Memory = nullptr;
+		FSlot* Slots = nullptr;
+		uint32* Displacements = nullptr;
+		uint32 NumSlots = 0;
+		uint32 NumBuckets = 0;
+		int32 NumBindings = 0;
+	};
+}
@@ -684,7 +684,7 @@ namespace DI
 		template <class... TArgumentTypes, class... TNames>
 		auto TryGetFromArgumentsNamed(EResolveErrorBehavior ErrorBehavior, TNames... Names) const
 		{
-			auto ResolvedPointers = MakeTuple(DiContainer.Resolve().template TryGetNamed<typename TBindingInstBaseType<TArgumentTypes>::Type>(Names, ErrorBehavior)...);
+			auto ResolvedPointers = DiContainer.Resolve().template TryGetManyNamed<typename TBindingInstBaseType<TArgumentTypes>::Type...>(ErrorBehavior, Names...);
 			return TryDerefAllInstances(ResolvedPointers);
 		}
 
@@ -0,0 +1,214 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Binding.h"
+
+namespace DI
+{
+	template <class T>
+	class TPooledBinding;
+
+	/**
+	 * Counters of a binding pool.
+	 */
+	struct FBindingPoolStats
+	{
+		/** Maximum number of released instances that are kept for reuse. */
+		int32 Capacity = 0;
+		/** Number of instances that are currently waiting to be reused. */
+		int32 NumFree = 0;
+		/** Number of instances that have been created by the factory. */
+		int32 NumCreated = 0;
+		/** Number of times an instance has been acquired, whether it has been reused or created. */
+		int32 NumAcquired = 0;
+		/** Number of times an instance has been released back to the pool. */
+		int32 NumReleased = 0;
+		/** Number of released instances that have been dropped because the pool was full. */
+		int32 NumDiscarded = 0;
+	};
+
+	/**
+	 * Handle to an instance that has been acquired from a pool.
+	 * Returns the instance to its pool when it is released or goes out of scope. Keeps the pool alive until then.
+	 * @note UObjects are only referenced by the pool while they are in it, so keep acquired UObjects referenced while using them across frames.
+	 */
+	template <class T>
+	class TPooledInstance
+	{
+	public:
+		using ElementType = TBindingInstValue<T>;
+
+		TPooledInstance() = default;
+
+		TPooledInstance(TRefCountPtr<TPooledBinding<T>> InPool, ElementType InInstance)
+			: Pool(MoveTemp(InPool)), Instance(MoveTemp(InInstance))
+		{
+		}
+
+		TPooledInstance(const TPooledInstance&) = delete;
+		TPooledInstance& operator=(const TPooledInstance&) = delete;
+
+		TPooledInstance(TPooledInstance&& Other)
+			: Pool(MoveTemp(Other.Pool)), Instance(MoveTemp(Other.Instance))
+		{
+			Other.Instance.Reset();
+		}
+
+		TPooledInstance& operator=(TPooledInstance&& Other)
+		{
+			if (this != &Other)
+			{
+				Release();
+				Pool = MoveTemp(Other.Pool);
+				Instance = MoveTemp(Other.Instance);
+				Other.Instance.Reset();
+			}
+			return *this;
+		}
+
+		~TPooledInstance()
+		{
+			Release();
+		}
+
+		bool IsValid() const
+		{
+			return Instance.IsSet();
+		}
+
+		explicit operator bool() const
+		{
+			return IsValid();
+		}
+
+		ElementType& Get()
+		{
+			check(IsValid());
+			return *Instance;
+		}
+
+		const ElementType& Get() const
+		{
+			check(IsValid());
+			return *Instance;
+		}
+
+		/** Return the instance to its pool. The handle is invalid afterward. */
+		void Release()
+		{
+			if (Instance.IsSet())
+			{
+				Pool->Release(MoveTemp(*Instance));
+				Instance.Reset();
+				Pool = nullptr;
+			}
+		}
+
+	private:
+		TRefCountPtr<TPooledBinding<T>> Pool;
+		TOptional<ElementType> Instance;
+	};
+
+	/**
+	 * Binding that hands out a separate instance of T to everyone who acquires from it.
+	 * Released instances are kept for reuse up to the capacity of the pool, so short-lived objects do not have to be created for every use.
+	 * Instances are handed out in the state they were released in, resetting them is up to the user.
+	 * Thread safe. The factory is called outside the lock, so it may acquire from other pools.
+	 */
+	template <class T>
+	class TPooledBinding final : public FBinding
+	{
+	public:
+		using Super = FBinding;
+		using ElementType = TBindingInstValue<T>;
+		using FFactory = TFunction<ElementType()>;
+
+		TPooledBinding(FBindingId BindingId, FFactory InFactory, int32 InCapacity)
+			: Super(MoveTemp(BindingId)), Factory(MoveTemp(InFactory))
+		{
+			check(GetId().GetKind() == EBindingKind::Pool);
+			check(Factory);
+			check(InCapacity >= 0);
+			Stats.Capacity = InCapacity;
+			FreeInstances.Reserve(InCapacity);
+		}
+
+		/** Get an instance from the pool or create a new one if the pool is empty. */
+		TPooledInstance<T> Acquire() const
+		{
+			TOptional<ElementType> Instance;
+			{
+				FScopeLock ScopeLock(&PoolLock);
+				++Stats.NumAcquired;
+				if (FreeInstances.Num() > 0)
+				{
+					Instance.Emplace(FreeInstances.Pop(EAllowShrinking::No));
+				}
+				else
+				{
+					++Stats.NumCreated;
+				}
+			}
+			if (!Instance.IsSet())
+			{
+				Instance.Emplace(Factory());
+			}
+			return TPooledInstance<T>(TRefCountPtr<TPooledBinding>(const_cast<TPooledBinding*>(this)), MoveTemp(*Instance));
+		}
+
+		/** Return an instance to the pool. Prefer releasing the TPooledInstance it has been acquired with. */
+		void Release(ElementType&& Instance) const
+		{
+			FScopeLock ScopeLock(&PoolLock);
+			++Stats.NumReleased;
+			if (FreeInstances.Num() < Stats.Capacity)
+			{
+				FreeInstances.Add(MoveTemp(Instance));
+			}
+			else
+			{
+				++Stats.NumDiscarded;
+			}
+		}
+
+		FBindingPoolStats GetStats() const
+		{
+			FScopeLock ScopeLock(&PoolLock);
+			FBindingPoolStats Result = Stats;
+			Result.NumFree = FreeInstances.Num();
+			return Result;
+		}
+
+		virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+		{
+			Super::AddReferencedObjects(Collector);
+			if constexpr (DI::THasUStruct<T>::Value)
+			{
+				FScopeLock ScopeLock(&PoolLock);
+				for (ElementType& Instance : FreeInstances)
+				{
+					if constexpr (TIsIInterface<T>::Value)
+					{
+						Instance.AddReferencedObjects(Collector);
+					}
+					else if constexpr (DI::THasUClass<T>::Value)
+					{
+						Collector.AddReferencedObject(Instance);
+					}
+					else
+					{
+						Collector.AddPropertyReferencesWithStructARO(T::StaticStruct(), &Instance);
+					}
+				}
+			}
+		}
+
+	private:
+		FFactory Factory;
+		mutable FCriticalSection PoolLock;
+		mutable TArray<ElementType> FreeInstances;
+		mutable FBindingPoolStats Stats;
+	};
+}
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Container/Binding.h"
+#include "Container/DiContainerConcept.h"
+#include "Container/PooledBinding.h"
 #include "WeakFuture.h"
 #include "ResolveErrorBehavior.h"
 
@@ -17,7 +19,24 @@ namespace DI
 	template <class TDiContainer>
 	class TResolveHelper
 	{
+		/**
+		 * Result of a lookup that is only used until the end of the current resolve.
+		 * Raw if the container supports it, otherwise a reference that keeps the binding alive until the resolve is done.
+		 */
+		using FResolveBindingPtr = std::conditional_t<DiContainerWithRawLookupConcept<TDiContainer>, const DI::FBinding*, TRefCountPtr<DI::FBinding>>;
+
 	public:
+		/**
+		 * What resolving a single instance of T returns.
+		 * Same as TBindingInstPtr, except that bound structs are copied out of containers that can drop a binding as soon as the lookup returns,
+		 * because a reference into the binding would dangle.
+		 */
+		template <class T>
+		using TResolveInstPtr = std::conditional_t<
+			DiContainerWithRawLookupConcept<TDiContainer>,
+			DI::TBindingInstPtr<T>,
+			DI::TBindingInstanceTypeSwitch<T, TObjectPtr<T>, TScriptInterface<T>, TOptional<T>, TSharedPtr<T>>>;
+
 		TResolveHelper(const TDiContainer& DiContainer) : DiContainer(DiContainer)
 		{
 		}
@@ -59,9 +78,9 @@ namespace DI
 				TIsDerivedFrom<TBindingType<FInstancedStruct>, DI::FRawDataBinding>::IsDerived,
 				"This code assumes that UStruct bindings inherit from FRawDataBinding"
 			);
-			if (TSharedPtr<DI::FRawDataBinding> BindingInstance = StaticCastSharedPtr<DI::FRawDataBinding>(DiContainer.FindBinding(BindingId)))
+			if (const FResolveBindingPtr Binding = this->FindBindingForResolve(BindingId))
 			{
-				BindingInstance->CopyRawData(OutStructMemory, StructType->GetStructureSize());
+				static_cast<const DI::FRawDataBinding&>(Binding->GetInstanceBinding()).CopyRawData(OutStructMemory, StructType->GetStructureSize());
 				return true;
 			}
 			else
@@ -71,6 +90,31 @@ namespace DI
 			return false;
 		}
 
+		/**
+		 * Get a read-only view of a bound UStruct without copying it.
+		 * Prefer this over TryGetUStruct for big structs that are read often.
+		 * The view keeps the binding alive, so the data stays valid for as long as the view exists, even in containers with concurrent writers.
+		 * @param StructType - struct class of the UStruct.
+		 * @param BindingName - (Optional) Name of the struct binding
+		 * @param ErrorBehavior - specified what to do if the binding is not found.
+		 * @return a view of the bound struct data. Invalid if the binding has not been found.
+		 */
+		FUStructBindingView TryGetUStructView(
+			UScriptStruct* StructType,
+			FName BindingName = NAME_None,
+			EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
+		{
+			FBindingId BindingId = FBindingId(FTypeId(StructType), BindingName);
+			if (TRefCountPtr<DI::FBinding> Binding = DiContainer.FindBinding(BindingId))
+			{
+				// Reference the binding that holds the data, which is not the found binding itself for lazy bindings.
+				const DI::FUStructBinding& StructBinding = static_cast<const DI::FUStructBinding&>(Binding->GetInstanceBinding());
+				return FUStructBindingView(TRefCountPtr<DI::FUStructBinding>(const_cast<DI::FUStructBinding*>(&StructBinding)));
+			}
+			HandleResolveError(BindingId, ErrorBehavior);
+			return {};
+		}
+
 		/**
 		 * Try to resolve a single instance by type.
 		 * @code
@@ -78,13 +122,12 @@ namespace DI
 		 * @endcode
 		 * @tparam T type of the binding that it was bound with.
 		 * @param ErrorBehavior - specified what to do if the binding is not found.
-		 * @return
+		 * @return the instance, see TResolveInstPtr.
 		 */
 		template <class T>
-		DI::TBindingInstPtr<T> TryGet(EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
+		TResolveInstPtr<T> TryGet(EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
 		{
-			FBindingId BindingId = MakeBindingId<T>();
-			return this->Get<T>(BindingId, ErrorBehavior);
+			return this->GetUnnamed<T>(ErrorBehavior);
 		}
 
 		/**
@@ -97,9 +140,37 @@ namespace DI
 		 * @return The bindings in the same order as the types. Failed lookups will have null values.
 		 */
 		template <class... Ts>
-		TTuple<DI::TBindingInstPtr<Ts>...> TryGetMany(EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
+		TTuple<TResolveInstPtr<Ts>...> TryGetMany(EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
+		{
+			return this->template TryGetManyNamed<Ts...>(ErrorBehavior, (TVoid<Ts>(), NAME_None)...);
+		}
+
+		/**
+		 * Try to resolve multiple named instances with a single lookup of all bindings.
+		 * Connected containers walk their ancestors once for all of them instead of once per instance.
+		 * @code
+		 * auto [ResolvedUService, ResolvedUInterface] = DiContainer.Resolve().TryGetManyNamed<USimpleUService, ISimpleInterface>(DI::EResolveErrorBehavior::ReturnNull, "Name1", "Name2");
+		 * @endcode
+		 * @tparam Ts - Types of the bindings that they were bound with. Only exact class matches can be resolved.
+		 * @param ErrorBehavior - specified what to do if any of the bindings are not found.
+		 * @param BindingNames - the name of each binding, in the same order as the types.
+		 * @return The bindings in the same order as the types. Failed lookups will have null values.
+		 */
+		template <class... Ts, class... TNames>
+		TTuple<TResolveInstPtr<Ts>...> TryGetManyNamed(EResolveErrorBehavior ErrorBehavior, TNames... BindingNames) const
 		{
-			return MakeTuple(this->Get<Ts>(MakeBindingId<Ts>(), ErrorBehavior)...);
+			static_assert(sizeof...(Ts) == sizeof...(TNames), "Every type needs exactly one binding name.");
+			if constexpr (sizeof...(Ts) == 0)
+			{
+				return {};
+			}
+			else
+			{
+				const FBindingId BindingIds[] = {MakeBindingId<Ts>(BindingNames)...};
+				FResolveBindingPtr Bindings[sizeof...(Ts)] = {};
+				this->FindBindingsForResolve(BindingIds, Bindings);
+				return this->template ResolveFoundBindings<Ts...>(BindingIds, Bindings, ErrorBehavior, TMakeIntegerSequence<uint32, sizeof...(Ts)>{});
+			}
 		}
 
 		/**
@@ -112,12 +183,117 @@ namespace DI
 		 * @return The bindings in the same order as the types. Failed lookups will have null values.
 		 */
 		template <class T>
-		DI::TBindingInstPtr<T> TryGetNamed(const FName& BindingName, EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
+		TResolveInstPtr<T> TryGetNamed(const FName& BindingName, EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
 		{
 			FBindingId BindingId = MakeBindingId<T>(BindingName);
 			return this->Get<T>(BindingId, ErrorBehavior);
 		}
 
+		/**
+		 * Call the visitor with every instance in the named set of T in this container and all of its ancestors, nearest container first.
+		 * Does not allocate, so prefer this over GetAll on hot paths.
+		 * @code
+		 * DiContainer.Resolve().ForEachInSet<ISimpleInterface>([](TScriptInterface<ISimpleInterface> Handler)
+		 * {
+		 *     Handler->DoSomething();
+		 * });
+		 * @endcode
+		 * @tparam T - Type of the set that the instances were added with.
+		 * @param Visitor - callable that takes a TBindingInstRef<T>. Must not add to the set while iterating.
+		 * @param SetName - (Optional) Name of the set.
+		 */
+		template <class T, class TVisitor>
+		void ForEachInSet(TVisitor&& Visitor, const FName& SetName = NAME_None) const
+		{
+			const FBindingId SetId = MakeSetBindingId<T>(SetName);
+			auto VisitSet = [&Visitor](const DI::FBinding& Binding)
+			{
+				static_cast<const DI::TBindingSet<T>&>(Binding).ForEach(Visitor);
+			};
+			if constexpr (requires { DiContainer.ForEachBinding(SetId.GetKey(), VisitSet); })
+			{
+				DiContainer.ForEachBinding(SetId.GetKey(), VisitSet);
+			}
+			else if (const FResolveBindingPtr Binding = this->FindBindingForResolve(SetId))
+			{
+				VisitSet(*Binding);
+			}
+		}
+
+		/**
+		 * Resolve all instances in the unnamed set of T in this container and all of its ancestors, nearest container first.
+		 * @tparam T - Type of the set that the instances were added with.
+		 * @tparam TAllocator - Allocator of the returned array, e.g. a TInlineAllocator to resolve small sets without allocating.
+		 * @return All instances of the set that are still valid. Empty if nothing has been added to the set.
+		 */
+		template <class T, class TAllocator = FDefaultAllocator>
+		TArray<DI::TBindingSetElement<T>, TAllocator> GetAll() const
+		{
+			return this->GetAllNamed<T, TAllocator>(NAME_None);
+		}
+
+		/**
+		 * Resolve all instances in the named set of T in this container and all of its ancestors, nearest container first.
+		 * @see GetAll
+		 */
+		template <class T, class TAllocator = FDefaultAllocator>
+		TArray<DI::TBindingSetElement<T>, TAllocator> GetAllNamed(const FName& SetName) const
+		{
+			TArray<DI::TBindingSetElement<T>, TAllocator> Instances;
+			this->ForEachInSet<T>([&Instances](const DI::TBindingSetElement<T>& Instance)
+			{
+				Instances.Add(Instance);
+			}, SetName);
+			return Instances;
+		}
+
+		/**
+		 * Acquire an instance from the unnamed pool of T.
+		 * The instance goes back to the pool when the returned handle is released or goes out of scope.
+		 * @code
+		 * DI::TPooledInstance<FSimpleNativeService> Service = DiContainer.Resolve().Acquire<FSimpleNativeService>();
+		 * Service.Get()->DoSomething();
+		 * @endcode
+		 * @tparam T - Type of the pool that it was bound with.
+		 * @param ErrorBehavior - specifies what to do if the pool is not bound.
+		 * @return the handle of the acquired instance. Invalid if the pool is not bound.
+		 */
+		template <class T>
+		TPooledInstance<T> Acquire(EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
+		{
+			return this->AcquireNamed<T>(NAME_None, ErrorBehavior);
+		}
+
+		/**
+		 * Acquire an instance from the named pool of T.
+		 * @see Acquire
+		 */
+		template <class T>
+		TPooledInstance<T> AcquireNamed(const FName& PoolName, EResolveErrorBehavior ErrorBehavior = GDefaultResolveErrorBehavior) const
+		{
+			const FBindingId PoolId = MakePoolBindingId<T>(PoolName);
+			if (const FResolveBindingPtr Binding = this->FindBindingForResolve(PoolId))
+			{
+				return static_cast<const DI::TPooledBinding<T>&>(*Binding).Acquire();
+			}
+			HandleResolveError(PoolId, ErrorBehavior);
+			return {};
+		}
+
+		/**
+		 * Get the counters of the named pool of T.
+		 * @return the counters, unset if the pool is not bound.
+		 */
+		template <class T>
+		TOptional<FBindingPoolStats> GetPoolStats(const FName& PoolName = NAME_None) const
+		{
+			if (const FResolveBindingPtr Binding = this->FindBindingForResolve(MakePoolBindingId<T>(PoolName)))
+			{
+				return static_cast<const DI::TPooledBinding<T>&>(*Binding).GetStats();
+			}
+			return {};
+		}
+
 		template <class T>
 		using TSubscriptionDelegateType = TDelegate<void(TBindingInstRef<T>)>;
 
@@ -257,27 +433,19 @@ namespace DI
 		{
 			FBindingId BindingId = MakeBindingId<TInstanceType>(BindingName);
 			auto [Promise, Future] = MakeWeakPromisePair<TBindingInstRef<TInstanceType>>();
-			TBindingInstPtr<TInstanceType> MaybeInstance = this->Get<TInstanceType>(BindingId, EResolveErrorBehavior::ReturnNull);
-			if (MaybeInstance)
+			if (const FResolveBindingPtr Binding = this->FindBindingForResolve(BindingId))
 			{
-				Promise.EmplaceValue(ToRefType(MaybeInstance));
+				Promise.EmplaceValue(DI::ResolveBinding<TInstanceType>(*Binding));
 			}
 			else
 			{
 				auto Callback = [PromiseCapture = MoveTemp(Promise)](const DI::FBinding& BindingInstance) mutable
 				{
-					const TBindingType<TInstanceType>& SpecificBinding = static_cast<const TBindingType<TInstanceType>&>(BindingInstance);
-					TBindingInstRef<TInstanceType> Resolved = SpecificBinding.Resolve();
+					// Lazy bindings construct their instance right here, so waiters are fulfilled as soon as it exists.
+					TBindingInstRef<TInstanceType> Resolved = DI::ResolveBinding<TInstanceType>(BindingInstance);
 					PromiseCapture.EmplaceValue(Resolved);
 				};
-				if (WaitingObject)
-				{
-					DiContainer.Subscribe(BindingId).AddWeakLambda(WaitingObject, Callback);
-				}
-				else
-				{
-					DiContainer.Subscribe(BindingId).AddLambda(Callback);
-				}
+				DiContainer.Subscribe(BindingId, MoveTemp(Callback), WaitingObject);
 			}
 			auto [NextPromise, NextFuture] = MakeWeakPromisePair<TBindingInstRef<TInstanceType>>();
 			Future.Then([BindingId, ErrorBehavior, NextPromise](TWeakFuture<TBindingInstRef<TInstanceType>> FutureInstance) mutable
@@ -298,16 +466,99 @@ namespace DI
 		 * Private so no one passes in a binding Id that does not match T
 		 */
 		template <class T>
-		DI::TBindingInstPtr<T> Get(const FBindingId& BindingId, EResolveErrorBehavior ErrorBehavior) const
+		TResolveInstPtr<T> Get(const FBindingId& BindingId, EResolveErrorBehavior ErrorBehavior) const
+		{
+			return this->template ResolveFoundBinding<T>(BindingId, this->FindBindingForResolve(BindingId), ErrorBehavior);
+		}
+
+		/** Resolve the instance of a binding that has already been looked up, or handle the error if it was not found. */
+		template <class T>
+		TResolveInstPtr<T> ResolveFoundBinding(const FBindingId& BindingId, const FResolveBindingPtr& BindingInstance, EResolveErrorBehavior ErrorBehavior) const
 		{
-			if (TSharedPtr<DI::FBinding> BindingInstance = DiContainer.FindBinding(BindingId))
+			if (BindingInstance)
 			{
-				return StaticCastSharedPtr<DI::TBindingType<T>>(BindingInstance)->Resolve();
+				return DI::ResolveBinding<T>(*BindingInstance);
 			}
 			HandleResolveError(BindingId, ErrorBehavior);
 			return {};
 		}
 
+		template <class... Ts, uint32... Indices>
+		TTuple<TResolveInstPtr<Ts>...> ResolveFoundBindings(
+			const FBindingId* BindingIds,
+			const FResolveBindingPtr* Bindings,
+			EResolveErrorBehavior ErrorBehavior,
+			TIntegerSequence<uint32, Indices...>) const
+		{
+			return TTuple<TResolveInstPtr<Ts>...>(this->template ResolveFoundBinding<Ts>(BindingIds[Indices], Bindings[Indices], ErrorBehavior)...);
+		}
+
+		/**
+		 * Find multiple bindings that are only used until the end of the current resolve, see FindBindingForResolve.
+		 * Uses a single batched lookup if the container supports it.
+		 */
+		void FindBindingsForResolve(TConstArrayView<FBindingId> BindingIds, TArrayView<FResolveBindingPtr> OutBindings) const
+		{
+			if constexpr (DiContainerWithRawLookupConcept<TDiContainer> && DiContainerWithBatchLookupConcept<TDiContainer>)
+			{
+				DiContainer.FindBindings(BindingIds, OutBindings);
+			}
+			else
+			{
+				for (int32 BindingIndex = 0; BindingIndex < BindingIds.Num(); ++BindingIndex)
+				{
+					OutBindings[BindingIndex] = this->FindBindingForResolve(BindingIds[BindingIndex]);
+				}
+			}
+		}
+
+		/**
+		 * Find a binding that is only used until the end of the current resolve.
+		 * Skips the reference count if the container supports it, otherwise the returned reference keeps the binding alive.
+		 */
+		FResolveBindingPtr FindBindingForResolve(const FBindingId& BindingId) const
+		{
+			if constexpr (DiContainerWithRawLookupConcept<TDiContainer>)
+			{
+				return DiContainer.FindBindingRaw(BindingId.GetKey());
+			}
+			else
+			{
+				return DiContainer.FindBinding(BindingId);
+			}
+		}
+
+		/**
+		 * Resolve the unnamed binding of T.
+		 * Uses the cached key of T if the container supports key lookups, so no binding ID has to be built on the hot path.
+		 */
+		template <class T>
+		TResolveInstPtr<T> GetUnnamed(EResolveErrorBehavior ErrorBehavior) const
+		{
+			if constexpr (DiContainerWithRawLookupConcept<TDiContainer>)
+			{
+				if (const DI::FBinding* BindingInstance = DiContainer.FindBindingRaw(GetUnnamedBindingKey<T>()))
+				{
+					return DI::ResolveBinding<T>(*BindingInstance);
+				}
+				HandleResolveError(MakeBindingId<T>(), ErrorBehavior);
+				return {};
+			}
+			else if constexpr (DiContainerWithKeyLookupConcept<TDiContainer>)
+			{
+				if (TRefCountPtr<DI::FBinding> BindingInstance = DiContainer.FindBinding(GetUnnamedBindingKey<T>()))
+				{
+					return DI::ResolveBinding<T>(*BindingInstance);
+				}
+				HandleResolveError(MakeBindingId<T>(), ErrorBehavior);
+				return {};
+			}
+			else
+			{
+				return this->Get<T>(MakeBindingId<T>(), ErrorBehavior);
+			}
+		}
+
 		const TDiContainer& DiContainer;
 	};
 }
@@ -95,6 +95,25 @@ public:
 	)
 	static bool TryResolveStructCopy(TScriptInterface<IDiContextInterface> DiContextInterface, UScriptStruct* StructType, FName BindingName, int32& OutStructData, EStructUtilsResult& Result);
 
+	/**
+	 * Resolve a single member of a bound struct without copying the rest of the struct.
+	 * Use this to read from big struct bindings like lookup tables or tuning data.
+	 * @param DiContextInterface The context that has the bindings
+	 * @param StructType UScriptStruct of the binding.
+	 * @param BindingName Name of the binding or None for a type binding
+	 * @param MemberName Name of the member as it is displayed in the editor.
+	 * @param OutValue Copy of the member. Must have the same type as the member.
+	 * @param Result Valid if the member was found, NotValid if the binding or the member was not found.
+	 * @return True if the member was found, False otherwise.
+	 */
+	UFUNCTION(
+		BlueprintCallable,
+		CustomThunk,
+		Category="Dependency Injection",
+		meta=( CustomStructureParam="OutValue", DefaultToSelf = "DiContextInterface", ReturnDisplayName="Is Valid", ExpandEnumAsExecs="Result" )
+	)
+	static bool TryResolveStructMember(TScriptInterface<IDiContextInterface> DiContextInterface, UScriptStruct* StructType, FName BindingName, FName MemberName, int32& OutValue, EStructUtilsResult& Result);
+
 
 	/**
 	 * Bind an object into the DI Context.
@@ -128,6 +147,7 @@ public:
 private:
 	DECLARE_FUNCTION(execTryResolveStruct);
 	DECLARE_FUNCTION(execTryResolveStructCopy);
+	DECLARE_FUNCTION(execTryResolveStructMember);
 	DECLARE_FUNCTION(execTryResolveInterface);
 	DECLARE_FUNCTION(execBindStruct);
 };
@@ -124,6 +124,16 @@ namespace DI
 		/* TNativeType */ TSharedPtr<T>>;
 
 
+	// Binding Instance Value Type (Non-nullable, owns or shares the instance)
+	template <class T>
+	using TBindingInstValue = TBindingInstanceTypeSwitch<
+		T,
+		/* TUObjectType */ TObjectPtr<T>,
+		/* TUInterfaceType */ TScriptInterface<T>,
+		/* TUStructType */ T,
+		/* TNativeType */ TSharedRef<T>>;
+
+
 	// Binding Instance Weak Ptr
 	template <class T>
 	using TBindingInstWeakPtr = TBindingInstanceTypeSwitch<
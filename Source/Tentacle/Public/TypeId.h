@@ -20,6 +20,22 @@ namespace DI
 	{
 		FTypeId MakeNativeTypeId(const TCHAR* TypeName);
 
+		/**
+		 * Get the dense process-wide index of a native type by the address of its type name.
+		 * The index is assigned the first time the address is seen and stays the same for the lifetime of the process.
+		 * @return the index of the type, 0 for nullptr.
+		 */
+		TENTACLE_API uint32 RegisterTypeIndex(const TCHAR* NativeTypeName);
+
+		/**
+		 * Get the dense process-wide index of a UStruct.
+		 * Indices are tied to the object and not to its address, so a type that is allocated where a destroyed one lived
+		 * (e.g. after hot reload) gets a new index.
+		 * Every thread remembers the types it has looked up recently, but hot paths should still cache the type ID, see GetTypeId.
+		 * @return the index of the type, 0 for nullptr.
+		 */
+		TENTACLE_API uint32 RegisterTypeIndex(const UStruct* Type);
+
 		//@see https://stackoverflow.com/a/38637849
 		template <typename... Ts>
 		struct TAlwaysFalse : std::false_type
@@ -56,6 +72,9 @@ private:
 
 	EIdType Type = EIdType::Invalid;
 
+	/** Dense index of the type. Lives in the padding between Type and the union so it does not grow the type id. */
+	uint32 TypeIndex = 0;
+
 	union
 	{
 		TObjectPtr<UStruct> UType;
@@ -63,7 +82,7 @@ private:
 	};
 
 	explicit FTypeId(const TCHAR* ClassId)
-		: Type(EIdType::NativeType), NativeClassId(ClassId)
+		: Type(EIdType::NativeType), TypeIndex(Private::RegisterTypeIndex(ClassId)), NativeClassId(ClassId)
 	{
 	}
 
@@ -87,6 +106,7 @@ public:
 	FTypeId& operator=(const FTypeId& Other)
 	{
 		Type = Other.Type;
+		TypeIndex = Other.TypeIndex;
 		switch (Other.Type)
 		{
 		case EIdType::Invalid:
@@ -104,6 +124,7 @@ public:
 	FTypeId& operator=(FTypeId&& Other)
 	{
 		Type = Other.Type;
+		TypeIndex = Other.TypeIndex;
 		switch (Other.Type)
 		{
 		case EIdType::Invalid:
@@ -116,12 +137,13 @@ public:
 			break;
 		}
 		Other.Type = EIdType::Invalid;
+		Other.TypeIndex = 0;
 		Other.UType = nullptr;
 		return *this;
 	}
 
 	explicit FTypeId(UStruct* TypeClass)
-		: Type(EIdType::UType), UType(TypeClass)
+		: Type(EIdType::UType), TypeIndex(Private::RegisterTypeIndex(TypeClass)), UType(TypeClass)
 	{
 	}
 
@@ -129,6 +151,15 @@ public:
 
 	FName GetName() const;
 
+	/**
+	 * Dense index that uniquely identifies this type in the running process.
+	 * 0 is reserved for the invalid type ID.
+	 */
+	FORCEINLINE uint32 GetTypeIndex() const
+	{
+		return TypeIndex;
+	}
+
 	UStruct* TryGetUType() const
 	{
 		if (Type == EIdType::UType)
@@ -162,9 +193,8 @@ public:
 
 	FORCEINLINE bool operator==(const FTypeId& Other) const
 	{
-		return
-			Type == Other.Type
-			&& GetTypeIdAddress() == Other.GetTypeIdAddress();
+		// Type indices are unique per type, so there is no need to compare the address itself.
+		return TypeIndex == Other.TypeIndex;
 	}
 };
 
@@ -172,7 +202,7 @@ public:
 
 FORCEINLINE uint32 GetTypeHash(const DI::FTypeId& TypeId)
 {
-	return HashCombine(GetTypeHash(TypeId.Type), GetTypeHash(TypeId.GetTypeIdAddress()));
+	return GetTypeHash(TypeId.TypeIndex);
 }
 
 #define DI_TYPEID_BODY(TypeName)\
@@ -0,0 +1,77 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/Binding.h"
+#include "Container/BindingArena.h"
+#include "Container/DiContainer.h"
+#include "Mocks/SimpleService.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_WORKER
+
+BEGIN_DEFINE_SPEC(FBindingArenaSpec, "Tentacle.BindingArena", EAutomationTestFlags::EngineFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProgramContext)
+
+	using FNativeBinding = DI::TSharedNativeDependencyBinding<FSimpleNativeService>;
+
+	static TRefCountPtr<FNativeBinding> MakeNativeBinding(DI::FBindingArena* Arena, int32 Number)
+	{
+		return DI::MakeBinding<FNativeBinding>(
+			Arena,
+			DI::MakeBindingId<FSimpleNativeService>(FName(TEXT("Binding"), Number)),
+			MakeShared<FSimpleNativeService>(Number)
+		);
+	}
+END_DEFINE_SPEC(FBindingArenaSpec)
+
+void FBindingArenaSpec::Define()
+{
+	It("should reuse the memory of released bindings", [this]
+	{
+		TRefCountPtr<DI::FBindingArena> Arena = new DI::FBindingArena();
+		TArray<TRefCountPtr<FNativeBinding>> Bindings;
+		for (int32 Number = 0; Number < 100; ++Number)
+		{
+			Bindings.Add(MakeNativeBinding(Arena, Number));
+		}
+		const SIZE_T ReservedSize = Arena->GetReservedSize();
+		TestTrue("Reserved some pages", ReservedSize > 0);
+
+		Bindings.Reset();
+		for (int32 Number = 0; Number < 100; ++Number)
+		{
+			Bindings.Add(MakeNativeBinding(Arena, Number));
+		}
+		TestEqual("Reserved size", Arena->GetReservedSize(), ReservedSize);
+		TestEqual("Value", Bindings[42]->Resolve()->A, 42);
+	});
+	It("should start with a small page and grow the following pages", [this]
+	{
+		TRefCountPtr<DI::FBindingArena> Arena = new DI::FBindingArena();
+		TestEqual("Reserved size before the first binding", Arena->GetReservedSize(), SIZE_T(0));
+
+		TArray<TRefCountPtr<FNativeBinding>> Bindings;
+		Bindings.Add(MakeNativeBinding(Arena, 0));
+		TestEqual("Reserved size after the first binding", Arena->GetReservedSize(), DI::FBindingArena::FirstPageSize);
+
+		for (int32 Number = 1; Number < 200; ++Number)
+		{
+			Bindings.Add(MakeNativeBinding(Arena, Number));
+		}
+		TestTrue("Grew to the maximum page size", Arena->GetReservedSize() >= DI::FBindingArena::FirstPageSize + DI::FBindingArena::MaxPageSize);
+	});
+	It("should keep bindings alive after their container has been destroyed", [this]
+	{
+		TRefCountPtr<DI::FBinding> Binding;
+		{
+			DI::FDiContainer DiContainer;
+			DiContainer.Bind().Instance<FSimpleNativeService>(MakeShared<FSimpleNativeService>(7));
+			Binding = DiContainer.FindBinding(DI::MakeBindingId<FSimpleNativeService>());
+		}
+		if (TestTrue("Binding", Binding.IsValid()))
+		{
+			TestEqual("Value", static_cast<FNativeBinding*>(Binding.GetReference())->Resolve()->A, 7);
+		}
+	});
+}
+
+#endif
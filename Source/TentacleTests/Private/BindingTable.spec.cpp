@@ -0,0 +1,194 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/BindingTable.h"
+#include "Container/FrozenBindingTable.h"
+#include "Mocks/SimpleService.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_WORKER
+
+BEGIN_DEFINE_SPEC(FBindingTableSpec, "Tentacle.BindingTable", EAutomationTestFlags::EngineFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProgramContext)
+
+	DI::FBindingTable BindingTable;
+
+	static DI::FBindingId MakeNamedId(int32 Number)
+	{
+		return DI::MakeBindingId<FSimpleNativeService>(FName(TEXT("Binding"), Number));
+	}
+
+	static TRefCountPtr<DI::FBinding> MakeNativeBinding(const DI::FBindingId& BindingId, int32 Value)
+	{
+		return TRefCountPtr<DI::FBinding>(DI::MakeBinding<DI::TSharedNativeDependencyBinding<FSimpleNativeService>>(nullptr, BindingId, MakeShared<FSimpleNativeService>(Value)));
+	}
+
+	static int32 GetValue(const TRefCountPtr<DI::FBinding>& Binding)
+	{
+		return static_cast<DI::TSharedNativeDependencyBinding<FSimpleNativeService>*>(Binding.GetReference())->Resolve()->A;
+	}
+END_DEFINE_SPEC(FBindingTableSpec)
+
+void FBindingTableSpec::Define()
+{
+	BeforeEach([this]
+	{
+		BindingTable = DI::FBindingTable();
+	});
+	It("should find added bindings", [this]
+	{
+		const DI::FBindingId BindingId = MakeNamedId(1);
+		BindingTable.Emplace(BindingId.GetKey(), MakeNativeBinding(BindingId, 1));
+
+		const TRefCountPtr<DI::FBinding>* Binding = BindingTable.Find(BindingId.GetKey());
+		if (TestNotNull("Binding", Binding))
+		{
+			TestEqual("Value", GetValue(*Binding), 1);
+		}
+		TestNull("Other binding", BindingTable.Find(MakeNamedId(2).GetKey()));
+	});
+	It("should distinguish keys by type, name and name number", [this]
+	{
+		TestTrue("Same id", MakeNamedId(1).GetKey() == MakeNamedId(1).GetKey());
+		TestFalse("Different name number", MakeNamedId(1).GetKey() == MakeNamedId(2).GetKey());
+		TestFalse("Different name", MakeNamedId(1).GetKey() == DI::MakeBindingId<FSimpleNativeService>(FName(TEXT("Other"), 1)).GetKey());
+		TestFalse("Different type", DI::MakeBindingId<FSimpleNativeService>().GetKey() == DI::MakeBindingId<USimpleUService>().GetKey());
+	});
+	It("should replace bindings with the same id", [this]
+	{
+		const DI::FBindingId BindingId = MakeNamedId(1);
+		BindingTable.Emplace(BindingId.GetKey(), MakeNativeBinding(BindingId, 1));
+		BindingTable.Emplace(BindingId.GetKey(), MakeNativeBinding(BindingId, 2));
+
+		TestEqual("Num", BindingTable.Num(), 1);
+		TestEqual("Value", GetValue(*BindingTable.Find(BindingId.GetKey())), 2);
+	});
+	It("should keep all bindings when growing", [this]
+	{
+		constexpr int32 NumBindings = 1000;
+		for (int32 Number = 0; Number < NumBindings; ++Number)
+		{
+			const DI::FBindingId BindingId = MakeNamedId(Number);
+			BindingTable.Emplace(BindingId.GetKey(), MakeNativeBinding(BindingId, Number));
+		}
+
+		TestEqual("Num", BindingTable.Num(), NumBindings);
+		int32 NumIterated = 0;
+		for (const auto& [Key, Binding] : BindingTable)
+		{
+			++NumIterated;
+		}
+		TestEqual("NumIterated", NumIterated, NumBindings);
+		for (int32 Number = 0; Number < NumBindings; ++Number)
+		{
+			const TRefCountPtr<DI::FBinding>* Binding = BindingTable.Find(MakeNamedId(Number).GetKey());
+			if (!TestNotNull(FString::Printf(TEXT("Binding %d"), Number), Binding))
+				return;
+			TestEqual("Value", GetValue(*Binding), Number);
+		}
+	});
+	It("should store named and unnamed bindings side by side", [this]
+	{
+		const DI::FBindingId UnnamedId = DI::MakeBindingId<FSimpleNativeService>();
+		const DI::FBindingId NamedId = MakeNamedId(1);
+		BindingTable.Emplace(UnnamedId.GetKey(), MakeNativeBinding(UnnamedId, 1));
+		BindingTable.Emplace(NamedId.GetKey(), MakeNativeBinding(NamedId, 2));
+
+		TestEqual("Num", BindingTable.Num(), 2);
+		TestEqual("Unnamed value", GetValue(*BindingTable.Find(UnnamedId.GetKey())), 1);
+		TestEqual("Named value", GetValue(*BindingTable.Find(NamedId.GetKey())), 2);
+		TestTrue("Unnamed key is the cached unnamed key", DI::GetUnnamedBindingKey<FSimpleNativeService>() == UnnamedId.GetKey());
+
+		int32 NumIterated = 0;
+		for (const auto& [Key, Binding] : BindingTable)
+		{
+			++NumIterated;
+		}
+		TestEqual("NumIterated", NumIterated, 2);
+
+		TestTrue("Remove unnamed", BindingTable.Remove(UnnamedId.GetKey()));
+		TestNull("Removed unnamed binding", BindingTable.Find(UnnamedId.GetKey()));
+		TestEqual("Num after remove", BindingTable.Num(), 1);
+	});
+	It("should store unnamed bindings of types beyond the unnamed slots in the hashed slots", [this]
+	{
+		const DI::FBindingId UnnamedId = DI::MakeBindingId<FSimpleNativeService>();
+		const DI::FBindingKey HighTypeIndexKey(TENTACLE_MAX_UNNAMED_BINDING_SLOTS + 5, NAME_None);
+		BindingTable.Emplace(UnnamedId.GetKey(), MakeNativeBinding(UnnamedId, 1));
+		BindingTable.Emplace(HighTypeIndexKey, MakeNativeBinding(UnnamedId, 2));
+
+		TestEqual("Num", BindingTable.Num(), 2);
+		TestEqual("Low type index value", GetValue(*BindingTable.Find(UnnamedId.GetKey())), 1);
+		TestEqual("High type index value", GetValue(*BindingTable.Find(HighTypeIndexKey)), 2);
+		TestNull("Other high type index", BindingTable.Find(DI::FBindingKey(TENTACLE_MAX_UNNAMED_BINDING_SLOTS + 6, NAME_None)));
+
+		int32 NumIterated = 0;
+		for (const auto& [Key, Binding] : BindingTable)
+		{
+			++NumIterated;
+		}
+		TestEqual("NumIterated", NumIterated, 2);
+
+		TestTrue("Remove high type index", BindingTable.Remove(HighTypeIndexKey));
+		TestNull("Removed high type index binding", BindingTable.Find(HighTypeIndexKey));
+		TestEqual("Num after remove", BindingTable.Num(), 1);
+	});
+	It("should find bindings after removing others", [this]
+	{
+		constexpr int32 NumBindings = 100;
+		for (int32 Number = 0; Number < NumBindings; ++Number)
+		{
+			const DI::FBindingId BindingId = MakeNamedId(Number);
+			BindingTable.Emplace(BindingId.GetKey(), MakeNativeBinding(BindingId, Number));
+		}
+		for (int32 Number = 0; Number < NumBindings; Number += 2)
+		{
+			TestTrue("Remove", BindingTable.Remove(MakeNamedId(Number).GetKey()));
+		}
+
+		TestEqual("Num", BindingTable.Num(), NumBindings / 2);
+		for (int32 Number = 0; Number < NumBindings; ++Number)
+		{
+			const bool bShouldBeFound = Number % 2 == 1;
+			TestEqual(FString::Printf(TEXT("Found %d"), Number), BindingTable.Find(MakeNamedId(Number).GetKey()) != nullptr, bShouldBeFound);
+		}
+	});
+	It("should freeze keys whose hashes collide", [this]
+	{
+		// Search type indices until two keys share their hash. The birthday bound makes this take around 80k keys.
+		TMap<uint32, uint32> HashToTypeIndex;
+		DI::FBindingKey FirstKey;
+		DI::FBindingKey SecondKey;
+		for (uint32 TypeIndex = TENTACLE_MAX_UNNAMED_BINDING_SLOTS; TypeIndex < (1u << 24); ++TypeIndex)
+		{
+			const DI::FBindingKey Key(TypeIndex, NAME_None);
+			if (const uint32* OtherTypeIndex = HashToTypeIndex.Find(Key.GetHash()))
+			{
+				FirstKey = DI::FBindingKey(*OtherTypeIndex, NAME_None);
+				SecondKey = Key;
+				break;
+			}
+			HashToTypeIndex.Add(Key.GetHash(), TypeIndex);
+		}
+		if (!TestTrue("Found colliding keys", FirstKey != SecondKey && FirstKey.GetHash() == SecondKey.GetHash()))
+			return;
+
+		const DI::FBindingId BindingId = DI::MakeBindingId<FSimpleNativeService>();
+		BindingTable.Emplace(FirstKey, MakeNativeBinding(BindingId, 1));
+		BindingTable.Emplace(SecondKey, MakeNativeBinding(BindingId, 2));
+		BindingTable.Emplace(BindingId.GetKey(), MakeNativeBinding(BindingId, 3));
+
+		const DI::FFrozenBindingTable FrozenBindingTable(BindingTable);
+		TestEqual("Num", FrozenBindingTable.Num(), 3);
+		const TRefCountPtr<DI::FBinding>* FirstBinding = FrozenBindingTable.Find(FirstKey);
+		const TRefCountPtr<DI::FBinding>* SecondBinding = FrozenBindingTable.Find(SecondKey);
+		const TRefCountPtr<DI::FBinding>* OtherBinding = FrozenBindingTable.Find(BindingId.GetKey());
+		if (!TestTrue("Found all bindings", FirstBinding && SecondBinding && OtherBinding))
+			return;
+
+		TestEqual("First value", GetValue(*FirstBinding), 1);
+		TestEqual("Second value", GetValue(*SecondBinding), 2);
+		TestEqual("Other value", GetValue(*OtherBinding), 3);
+	});
+}
+
+#endif
@@ -0,0 +1,150 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Container/ConcurrentDiContainer.h"
+#include "Async/ParallelFor.h"
+#include "Mocks/SimpleService.h"
+#include "Misc/AutomationTest.h"
+#include "Tasks/Task.h"
+
+#if WITH_AUTOMATION_WORKER
+
+BEGIN_DEFINE_SPEC(FConcurrentDiContainerSpec, "Tentacle.ConcurrentDiContainer",
+                  EAutomationTestFlags::EngineFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProgramContext)
+
+	TSharedPtr<DI::FConcurrentDiContainer> DiContainer;
+END_DEFINE_SPEC(FConcurrentDiContainerSpec)
+
+void FConcurrentDiContainerSpec::Define()
+{
+	BeforeEach([this]
+	{
+		DiContainer = MakeShared<DI::FConcurrentDiContainer>();
+	});
+	AfterEach([this]
+	{
+		DiContainer.Reset();
+	});
+	It("should resolve bindings", [this]
+	{
+		TSharedRef<FSimpleNativeService> Service = MakeShared<FSimpleNativeService>();
+		TestTrue("BindResult", DiContainer->Bind().Instance<FSimpleNativeService>(Service) == DI::EBindResult::Bound);
+		TestTrue("TryGet<FSimpleNativeService>()", DiContainer->Resolve().TryGet<FSimpleNativeService>() == Service);
+		TestTrue("Second BindResult", DiContainer->Bind().Instance<FSimpleNativeService>(Service, DI::EBindConflictBehavior::None) == DI::EBindResult::Conflict);
+	});
+	It("should resolve copies of bound structs", [this]
+	{
+		DiContainer->Bind().Instance<FSimpleUStructService>(FSimpleUStructService(5));
+
+		using FResolved = decltype(DiContainer->Resolve().TryGet<FSimpleUStructService>());
+		static_assert(std::is_same_v<FResolved, TOptional<FSimpleUStructService>>, "Struct bindings can be dropped right after the lookup, so they have to be copied.");
+		const TOptional<FSimpleUStructService> Resolved = DiContainer->Resolve().TryGet<FSimpleUStructService>();
+		if (TestTrue("Resolved.IsSet()", Resolved.IsSet()))
+		{
+			TestEqual("Resolved->A", Resolved->A, 5);
+		}
+
+		const DI::FUStructBindingView View = DiContainer->Resolve().TryGetUStructView(FSimpleUStructService::StaticStruct());
+		if (TestTrue("View.IsValid()", View.IsValid()))
+		{
+			TestEqual("View A", View.Get<FSimpleUStructService>().A, 5);
+		}
+	});
+	It("should resolve from worker threads while binding", [this]
+	{
+		TSharedRef<FSimpleNativeService> Service = MakeShared<FSimpleNativeService>();
+		DiContainer->Bind().Instance<FSimpleNativeService>(Service);
+
+		constexpr int32 NumBindings = 100;
+		UE::Tasks::FTask BindTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this]
+		{
+			for (int32 Number = 0; Number < NumBindings; ++Number)
+			{
+				DiContainer->Bind().NamedInstance<FSimpleNativeService>(MakeShared<FSimpleNativeService>(Number), FName(TEXT("Binding"), Number));
+			}
+		});
+
+		std::atomic<int32> NumResolved = 0;
+		ParallelFor(10000, [this, &NumResolved, &Service](int32)
+		{
+			if (DiContainer->Resolve().TryGet<FSimpleNativeService>() == Service)
+			{
+				++NumResolved;
+			}
+		});
+		BindTask.Wait();
+
+		TestEqual("NumResolved", NumResolved.load(), 10000);
+		TestTrue("Last named binding", DiContainer->Resolve().TryGetNamed<FSimpleNativeService>(FName(TEXT("Binding"), NumBindings - 1)).IsValid());
+	});
+	It("should keep replaced bindings and appended sets alive for readers on worker threads", [this]
+	{
+		constexpr int32 NumBindings = 200;
+		TArray<USimpleUService*> Services;
+		for (int32 Number = 0; Number < NumBindings; ++Number)
+		{
+			Services.Add(NewObject<USimpleUService>());
+		}
+		DiContainer->Bind().Instance<USimpleUService>(Services[0]);
+
+		std::atomic<bool> bIsBinding = true;
+		std::atomic<int32> NumResolved = 0;
+		TArray<UE::Tasks::FTask> ReadTasks;
+		for (int32 ReaderIndex = 0; ReaderIndex < 4; ++ReaderIndex)
+		{
+			ReadTasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, &bIsBinding, &NumResolved]
+			{
+				while (bIsBinding.load())
+				{
+					if (DiContainer->Resolve().TryGet<USimpleUService>(DI::EResolveErrorBehavior::ReturnNull))
+					{
+						++NumResolved;
+					}
+					DiContainer->Resolve().ForEachInSet<FSimpleNativeService>([](const TSharedRef<FSimpleNativeService>& Service)
+					{
+						check(Service->A > 0);
+					});
+				}
+			}));
+		}
+
+		// Invalid bindings are replaced by the next bind and every append to the set copies it, so readers keep losing their bindings.
+		for (int32 Number = 1; Number < NumBindings; ++Number)
+		{
+			Services[Number - 1]->MarkAsGarbage();
+			DiContainer->Bind().Instance<USimpleUService>(Services[Number]);
+			DiContainer->Bind().AddToSet<FSimpleNativeService>(MakeShared<FSimpleNativeService>(Number));
+		}
+		bIsBinding = false;
+		UE::Tasks::Wait(ReadTasks);
+
+		TestTrue("NumResolved", NumResolved.load() > 0);
+		TestEqual("Last binding", DiContainer->Resolve().TryGet<USimpleUService>().Get(), Services.Last());
+		TestEqual("Set size", DiContainer->Resolve().GetAll<FSimpleNativeService>().Num(), NumBindings - 1);
+	});
+	It("should resolve the same instance of lazy bindings on all worker threads", [this]
+	{
+		std::atomic<int32> NumConstructed = 0;
+		DiContainer->Bind().Lazy<FSimpleNativeService>([&NumConstructed]
+		{
+			return MakeShared<FSimpleNativeService>(++NumConstructed);
+		});
+
+		constexpr int32 NumResolves = 64;
+		TArray<TSharedPtr<FSimpleNativeService>> Resolved;
+		Resolved.SetNum(NumResolves);
+		ParallelFor(NumResolves, [this, &Resolved](int32 Index)
+		{
+			Resolved[Index] = DiContainer->Resolve().TryGet<FSimpleNativeService>();
+		});
+
+		TestTrue("NumConstructed", NumConstructed.load() >= 1);
+		for (int32 Index = 0; Index < NumResolves; ++Index)
+		{
+			if (!TestTrue(FString::Printf(TEXT("Same instance %d"), Index), Resolved[Index].IsValid() && Resolved[Index] == Resolved[0]))
+				return;
+		}
+	});
+}
+
+#endif
@@ -61,7 +61,154 @@ void FConnectedDiContainerSpec::Define()
 
 			TestEqual("ChildContainer.Resolve().TryGet<USimpleUService>()", ChildContainer->Resolve().TryGet<USimpleUService>(), Service);
 		});
+		It("should search ancestors that have been connected after binding", [this]
+		{
+			TSharedRef<DI::FChainedDiContainer> GrandParentContainer = MakeShared<DI::FChainedDiContainer>();
+			GrandParentContainer->Bind().Instance<USimpleUService>(Service);
+			TestFalse("Resolved before connecting", bool(ChildContainer->Resolve().TryGet<USimpleUService>(DI::EResolveErrorBehavior::ReturnNull)));
+
+			ParentContainer->SetParentContainer(GrandParentContainer);
+
+			TestEqual("Resolved after connecting", ChildContainer->Resolve().TryGet<USimpleUService>(), Service);
+		});
+		It("should not return cached bindings of previous parents", [this]
+		{
+			USimpleUService* OtherService = NewObject<USimpleUService>();
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+			OtherParentContainer->Bind().Instance<USimpleUService>(OtherService);
+			TestEqual("Resolved before reparenting", ChildContainer->Resolve().TryGet<USimpleUService>(), Service);
 
+			ChildContainer->SetParentContainer(OtherParentContainer);
+
+			TestEqual("Resolved after reparenting", ChildContainer->Resolve().TryGet<USimpleUService>(), OtherService);
+		});
+		It("should not return cached bindings that have been shadowed by a new bind", [this]
+		{
+			USimpleUService* OtherService = NewObject<USimpleUService>();
+			OtherParentContainer->Bind().Instance<USimpleUService>(OtherService);
+			TestEqual("Resolved before bind", ChildContainer->Resolve().TryGet<USimpleUService>(), OtherService);
+
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+
+			TestEqual("Resolved after bind", ChildContainer->Resolve().TryGet<USimpleUService>(), Service);
+		});
+		It("should remove parents next to parents that have been destroyed", [this]
+		{
+			USimpleUService* OtherService = NewObject<USimpleUService>();
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+			OtherParentContainer->Bind().Instance<USimpleUService>(OtherService);
+			TSharedPtr<DI::FChainedDiContainer> DestroyedParentContainer = MakeShared<DI::FChainedDiContainer>();
+			ForkingDiContainer->AddParentContainer(DestroyedParentContainer.ToSharedRef(), 2);
+			DestroyedParentContainer.Reset();
+
+			ForkingDiContainer->RemoveParentContainer(ParentContainer);
+
+			TestEqual("Resolved after removing the parent", ChildContainer->Resolve().TryGet<USimpleUService>(), OtherService);
+		});
+		It("should not search parents that have been destroyed", [this]
+		{
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+			TestEqual("Resolved before destroying the parent", ChildContainer->Resolve().TryGet<USimpleUService>(), Service);
+
+			ParentContainer.Reset();
+
+			TestFalse("Resolved after destroying the parent", bool(ChildContainer->Resolve().TryGet<USimpleUService>(DI::EResolveErrorBehavior::ReturnNull)));
+		});
+		It("should find bindings without taking a reference", [this]
+		{
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+			const DI::FBinding* Binding = ChildContainer->FindBindingRaw(DI::GetUnnamedBindingKey<USimpleUService>());
+			if (TestNotNull("Binding", Binding))
+			{
+				TestTrue("Binding->GetId()", Binding->GetId() == DI::MakeBindingId<USimpleUService>());
+			}
+		});
+		It("should resolve many bindings of different ancestors at once", [this]
+		{
+			TSharedRef<FSimpleNativeService> NativeService = MakeShared<FSimpleNativeService>();
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+			OtherParentContainer->Bind().NamedInstance<FSimpleNativeService>(NativeService, "Native");
+			ChildContainer->Bind().Instance<FSimpleUStructService>(FSimpleUStructService(42));
+
+			auto [ResolvedUService, ResolvedNativeService, ResolvedStructService, MissingService] = ChildContainer->Resolve()
+				.TryGetManyNamed<USimpleUService, FSimpleNativeService, FSimpleUStructService, FSimpleNativeService>(
+					DI::EResolveErrorBehavior::ReturnNull, NAME_None, "Native", NAME_None, "Missing");
+
+			TestEqual("ResolvedUService", ResolvedUService, Service);
+			TestTrue("ResolvedNativeService", ResolvedNativeService == NativeService);
+			TestTrue("ResolvedStructService", ResolvedStructService.IsSet());
+			TestFalse("MissingService", MissingService.IsValid());
+		});
+	});
+	Describe("Freeze", [this]
+	{
+		It("should resolve all bindings of frozen containers", [this]
+		{
+			constexpr int32 NumBindings = 100;
+			for (int32 Number = 0; Number < NumBindings; ++Number)
+			{
+				ParentContainer->Bind().NamedInstance<FSimpleNativeService>(MakeShared<FSimpleNativeService>(Number), FName(TEXT("Binding"), Number));
+			}
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+
+			ParentContainer->Freeze();
+
+			TestEqual("ChildContainer.Resolve().TryGet<USimpleUService>()", ChildContainer->Resolve().TryGet<USimpleUService>(), Service);
+			for (int32 Number = 0; Number < NumBindings; ++Number)
+			{
+				const TSharedPtr<FSimpleNativeService> Resolved = ChildContainer->Resolve().TryGetNamed<FSimpleNativeService>(FName(TEXT("Binding"), Number));
+				if (!TestTrue(FString::Printf(TEXT("Resolved %d"), Number), Resolved.IsValid()))
+					return;
+				TestEqual("Resolved->A", Resolved->A, Number);
+			}
+		});
+		It("should reject binds", [this]
+		{
+			ParentContainer->Freeze(DI::EFrozenBindBehavior::Reject);
+
+			AddExpectedError(TEXT("container is frozen"), EAutomationExpectedErrorFlags::Contains, 1);
+			TestTrue("BindResult", ParentContainer->Bind().Instance<USimpleUService>(Service) == DI::EBindResult::Frozen);
+		});
+		It("should accept binds when copying on write", [this]
+		{
+			ParentContainer->Freeze(DI::EFrozenBindBehavior::CopyOnWrite);
+
+			TestTrue("BindResult", ParentContainer->Bind().Instance<USimpleUService>(Service) == DI::EBindResult::Bound);
+			TestTrue("IsFrozen", ParentContainer->IsFrozen());
+			TestEqual("ChildContainer.Resolve().TryGet<USimpleUService>()", ChildContainer->Resolve().TryGet<USimpleUService>(), Service);
+		});
+	});
+	Describe("Sets", [this]
+	{
+		It("should resolve sets of the whole chain", [this]
+		{
+			USimpleUService* ParentService = NewObject<USimpleUService>();
+			USimpleUService* OtherParentService = NewObject<USimpleUService>();
+			ChildContainer->Bind().AddToSet<USimpleUService>(Service);
+			ParentContainer->Bind().AddToSet<USimpleUService>(ParentService);
+			TestTrue("BindResult", OtherParentContainer->Bind().AddToSet<USimpleUService>(OtherParentService) == DI::EBindResult::Bound);
+			TestTrue("Second BindResult", OtherParentContainer->Bind().AddToSet<USimpleUService>(Service) == DI::EBindResult::Bound);
+
+			TArray<TObjectPtr<USimpleUService>> Services = ChildContainer->Resolve().GetAll<USimpleUService>();
+			TestEqual("Services", Services, TArray<TObjectPtr<USimpleUService>>{Service, ParentService, OtherParentService, Service});
+			TestEqual("Other set", ChildContainer->Resolve().GetAllNamed<USimpleUService>("Other").Num(), 0);
+			TestFalse("Instance binding", ChildContainer->Resolve().TryGet<USimpleUService>(DI::EResolveErrorBehavior::ReturnNull) != nullptr);
+		});
+		It("should visit ancestors that are shared by multiple parents once", [this]
+		{
+			TSharedRef<DI::FChainedDiContainer> GrandParentContainer = MakeShared<DI::FChainedDiContainer>();
+			ParentContainer->SetParentContainer(GrandParentContainer);
+			OtherParentContainer->SetParentContainer(GrandParentContainer);
+			GrandParentContainer->Bind().AddToSet<USimpleUService>(Service);
+
+			TestEqual("Services", ChildContainer->Resolve().GetAll<USimpleUService>(), TArray<TObjectPtr<USimpleUService>>{Service});
+
+			GrandParentContainer->Freeze(DI::EFrozenBindBehavior::CopyOnWrite);
+			USimpleUService* OtherService = NewObject<USimpleUService>();
+			GrandParentContainer->Bind().AddToSet<USimpleUService>(OtherService);
+
+			TestEqual("Services after freezing", ChildContainer->Resolve().GetAll<USimpleUService>(), TArray<TObjectPtr<USimpleUService>>{Service, OtherService});
+		});
 	});
 	Describe("BindSpecific", [this]
 	{
@@ -74,6 +221,114 @@ void FConnectedDiContainerSpec::Define()
 			});
 			ParentContainer->Bind().Instance<USimpleUService>(Service);
 		});
+		LatentIt("should notify children that have started waiting before being connected", FTimespan::FromSeconds(1),[this](FDoneDelegate Done)
+		{
+			TSharedRef<DI::FChainedDiContainer> GrandChildContainer = MakeShared<DI::FChainedDiContainer>();
+			GrandChildContainer->Resolve().WaitFor<USimpleUService>().Next([Done, GrandChildContainer, this](TOptional<TObjectPtr<USimpleUService>> ResolvedService)
+			{
+				TestEqual("ResolvedService", *ResolvedService, Service);
+				Done.Execute();
+			});
+			GrandChildContainer->SetParentContainer(ChildContainer);
+			OtherParentContainer->Bind().Instance<FSimpleNativeService>(MakeShared<FSimpleNativeService>(20));
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+		});
+		LatentIt("should notify waiting descendants when connected to ancestors that are already bound", FTimespan::FromSeconds(1),[this](FDoneDelegate Done)
+		{
+			TSharedRef<DI::FChainedDiContainer> DetachedContainer = MakeShared<DI::FChainedDiContainer>();
+			TSharedRef<DI::FChainedDiContainer> DetachedChildContainer = MakeShared<DI::FChainedDiContainer>();
+			DetachedChildContainer->SetParentContainer(DetachedContainer);
+			DetachedChildContainer->Resolve().WaitFor<USimpleUService>().Next([Done, DetachedChildContainer, this](TOptional<TObjectPtr<USimpleUService>> ResolvedService)
+			{
+				TestEqual("ResolvedService", *ResolvedService, Service);
+				Done.Execute();
+			});
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+
+			DetachedContainer->SetParentContainer(ChildContainer);
+		});
+		It("should not fulfill waits with ancestor bindings that are shadowed by queued deferred bindings", [this]
+		{
+			USimpleUService* DetachedService = NewObject<USimpleUService>();
+			TSharedRef<DI::FChainedDiContainer> DetachedContainer = MakeShared<DI::FChainedDiContainer>();
+			DetachedContainer->SetNotificationMode(DI::EBindingNotificationMode::Deferred);
+			TArray<USimpleUService*> ResolvedServices;
+			DetachedContainer->Resolve().WaitFor<USimpleUService>().Next([&ResolvedServices](TOptional<TObjectPtr<USimpleUService>> ResolvedService)
+			{
+				ResolvedServices.Add(ResolvedService.IsSet() ? ResolvedService->Get() : nullptr);
+			});
+			DetachedContainer->Bind().Instance<USimpleUService>(DetachedService);
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+
+			DetachedContainer->SetParentContainer(ChildContainer);
+			TestEqual("ResolvedServices.Num() before flush", ResolvedServices.Num(), 0);
+
+			DetachedContainer->FlushNotifications();
+			if (TestEqual("ResolvedServices.Num()", ResolvedServices.Num(), 1))
+			{
+				TestEqual("ResolvedServices[0]", ResolvedServices[0], DetachedService);
+			}
+		});
+	});
+	Describe("Unsubscribe", [this]
+	{
+		It("should keep pending keys balanced when unsubscribing siblings while being notified", [this]
+		{
+			const DI::FBindingId BindingId = DI::MakeBindingId<USimpleUService>();
+			bool bWasChildNotified = false;
+			bool bWasSiblingNotified = false;
+			DI::FBindingSubscriptionHandle SiblingHandle;
+			ParentContainer->Subscribe(BindingId, [this, &BindingId, &SiblingHandle](const DI::FBinding&)
+			{
+				TestTrue("Unsubscribe sibling", ParentContainer->Unsubscribe(BindingId, SiblingHandle));
+			}, nullptr);
+			SiblingHandle = ParentContainer->Subscribe(BindingId, [&bWasSiblingNotified](const DI::FBinding&) { bWasSiblingNotified = true; }, nullptr);
+			ChildContainer->Subscribe(BindingId, [&bWasChildNotified](const DI::FBinding&) { bWasChildNotified = true; }, nullptr);
+
+			ParentContainer->Bind().Instance<USimpleUService>(Service);
+
+			TestFalse("bWasSiblingNotified", bWasSiblingNotified);
+			TestTrue("bWasChildNotified", bWasChildNotified);
+			auto HasNoPendingKeys = [](const DI::FConnectedDiContainer& Container) { return Container.GetSubtreePendingKeys().IsEmpty(); };
+			TestTrue("Parent has no pending keys", HasNoPendingKeys(*ParentContainer));
+			TestTrue("Other parent has no pending keys", HasNoPendingKeys(*OtherParentContainer));
+			TestTrue("Forking container has no pending keys", HasNoPendingKeys(*ForkingDiContainer));
+			TestTrue("Child has no pending keys", HasNoPendingKeys(*ChildContainer));
+		});
+	});
+	Describe("GarbageCollection", [this]
+	{
+		It("should destroy containers that are only kept alive by abandoned waiters", [this]
+		{
+			USimpleUService* WaitingObject = NewObject<USimpleUService>();
+			TSharedPtr<DI::FChainedDiContainer> DetachedContainer = MakeShared<DI::FChainedDiContainer>();
+			const TWeakPtr<DI::FChainedDiContainer> WeakDetachedContainer = DetachedContainer;
+			DetachedContainer->Subscribe(DI::MakeBindingId<USimpleUService>(), [DetachedContainer](const DI::FBinding&)
+			{
+			}, WaitingObject);
+			DetachedContainer.Reset();
+			TestTrue("Kept alive by its waiter", WeakDetachedContainer.IsValid());
+
+			WaitingObject->MarkAsGarbage();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+			TestFalse("Destroyed with its waiter", WeakDetachedContainer.IsValid());
+		});
+	});
+	Describe("BindSpecificMany", [this]
+	{
+		LatentIt("should notify children after the whole batch is bound", FTimespan::FromSeconds(1),[this](FDoneDelegate Done)
+		{
+			ChildContainer->Resolve().WaitFor<USimpleUService>().Next([Done,this](TOptional<TObjectPtr<USimpleUService>> ResolvedService)
+			{
+				TestEqual("ResolvedService", *ResolvedService, Service);
+				TestTrue("Other batch binding is resolvable", ChildContainer->Resolve().TryGet<FSimpleNativeService>().IsValid());
+				Done.Execute();
+			});
+			ParentContainer->Bind().Batch()
+				.Instance<USimpleUService>(Service)
+				.Instance<FSimpleNativeService>(MakeShared<FSimpleNativeService>(20));
+		});
 	});
 }
 
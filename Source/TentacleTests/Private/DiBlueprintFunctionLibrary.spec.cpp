@@ -0,0 +1,85 @@
+﻿// Copyright 2026 singinwhale https://www.singinwhale.com and contributors. Distributed under the MIT license.
+
+
+#include "Contexts/DiBlueprintFunctionLibrary.h"
+#include "Contexts/DiContainerObject.h"
+#include "Mocks/SimpleService.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_AUTOMATION_WORKER
+
+BEGIN_DEFINE_SPEC(FDiBlueprintFunctionLibrarySpec, "Tentacle.DiBlueprintFunctionLibrary",
+                  EAutomationTestFlags::EngineFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProgramContext)
+
+	TObjectPtr<UDiContainerObject> DiContext;
+
+	/** Same layout as the parameters that blueprints pass to TryResolveStructMember, with an int32 for the wildcard value. */
+	struct FTryResolveStructMemberParams
+	{
+		TScriptInterface<IDiContextInterface> DiContextInterface;
+		UScriptStruct* StructType = nullptr;
+		FName BindingName;
+		FName MemberName;
+		int32 OutValue = 0;
+		EStructUtilsResult Result = EStructUtilsResult::NotValid;
+		bool ReturnValue = false;
+	};
+
+	/** Call TryResolveStructMember through its custom thunk, the same way blueprints do. */
+	FTryResolveStructMemberParams CallTryResolveStructMember(FName MemberName) const
+	{
+		FTryResolveStructMemberParams Params;
+		Params.DiContextInterface = DiContext.Get();
+		Params.StructType = FMemberUStructService::StaticStruct();
+		Params.MemberName = MemberName;
+
+		UFunction* Function = UDiBlueprintFunctionLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UDiBlueprintFunctionLibrary, TryResolveStructMember));
+		check(Function);
+		GetMutableDefault<UDiBlueprintFunctionLibrary>()->ProcessEvent(Function, &Params);
+		return Params;
+	}
+END_DEFINE_SPEC(FDiBlueprintFunctionLibrarySpec)
+
+void FDiBlueprintFunctionLibrarySpec::Define()
+{
+	BeforeEach([this]
+	{
+		DiContext = NewObject<UDiContainerObject>();
+		FMemberUStructService Service;
+		Service.Number = 7;
+		Service.Text = TEXT("Seven");
+		DiContext->GetDiContainer().Bind().Instance<FMemberUStructService>(Service);
+	});
+	AfterEach([this]
+	{
+		DiContext = nullptr;
+	});
+	Describe("TryResolveStructMember", [this]
+	{
+		It("should copy the member of the bound struct", [this]
+		{
+			const FTryResolveStructMemberParams Params = CallTryResolveStructMember(GET_MEMBER_NAME_CHECKED(FMemberUStructService, Number));
+			TestTrue("ReturnValue", Params.ReturnValue);
+			TestTrue("Result", Params.Result == EStructUtilsResult::Valid);
+			TestEqual("OutValue", Params.OutValue, 7);
+		});
+		It("should fail for members that do not exist", [this]
+		{
+			AddExpectedError(TEXT("has no member"), EAutomationExpectedErrorFlags::Contains, 1);
+			const FTryResolveStructMemberParams Params = CallTryResolveStructMember(TEXT("Missing"));
+			TestFalse("ReturnValue", Params.ReturnValue);
+			TestTrue("Result", Params.Result == EStructUtilsResult::NotValid);
+			TestEqual("OutValue", Params.OutValue, 0);
+		});
+		It("should fail for members of another type than the value", [this]
+		{
+			AddExpectedError(TEXT("can not be written to"), EAutomationExpectedErrorFlags::Contains, 1);
+			const FTryResolveStructMemberParams Params = CallTryResolveStructMember(GET_MEMBER_NAME_CHECKED(FMemberUStructService, Text));
+			TestFalse("ReturnValue", Params.ReturnValue);
+			TestTrue("Result", Params.Result == EStructUtilsResult::NotValid);
+			TestEqual("OutValue", Params.OutValue, 0);
+		});
+	});
+}
+
+#endif
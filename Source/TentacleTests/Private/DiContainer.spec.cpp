@@ -2,6 +2,7 @@
 
 
 #include "Container/DiContainer.h"
+#include "Contexts/DiContainerObject.h"
 #include "Examples/ExampleComponent.h"
 #include "Examples/ExampleNative.h"
 #include "Mocks/SimpleService.h"
@@ -48,6 +49,70 @@ void FDiContainerSpec::Define()
 			const TSharedPtr<FSimpleNativeService> Resolved = DiContainer.Resolve().TryGet<FSimpleNativeService>();
 			TestEqual("Resolved->A", Resolved->A, 20);
 		});
+		It("should bind batches", [this]
+		{
+			const TObjectPtr<USimpleUService> Service = NewObject<USimpleUService>();
+			const TSharedRef<FSimpleNativeService> NativeService = MakeShared<FSimpleNativeService>(20);
+			const DI::EBindResult BindResult = DiContainer.Bind().Batch()
+				.Instance<USimpleUService>(Service)
+				.NamedInstance<FSimpleNativeService>(NativeService, "SomeName")
+				.Commit();
+
+			TestTrue("BindResult", BindResult == DI::EBindResult::Bound);
+			TestEqual("DiContainer.Resolve().TryGet<USimpleUService>()", DiContainer.Resolve().TryGet<USimpleUService>(), Service);
+			TestTrue("DiContainer.Resolve().TryGetNamed<FSimpleNativeService>()", DiContainer.Resolve().TryGetNamed<FSimpleNativeService>("SomeName") == NativeService);
+		});
+		It("should bind UObjects polymorphically", [this]
+		{
+			const TObjectPtr<USimpleInterfaceImplementation> Service = NewObject<USimpleInterfaceImplementation>();
+			Service->A = 5;
+			TestTrue("BindResult", DiContainer.Bind().Polymorphic<USimpleInterfaceImplementation>(Service) == DI::EBindResult::Bound);
+
+			TestEqual("TryGet<USimpleInterfaceImplementation>()", DiContainer.Resolve().TryGet<USimpleInterfaceImplementation>(), Service);
+			TScriptInterface<ISimpleInterface> ResolvedInterface = DiContainer.Resolve().TryGet<ISimpleInterface>();
+			if (TestTrue("TryGet<ISimpleInterface>()", bool(ResolvedInterface)))
+			{
+				TestEqual("ResolvedInterface->GetA()", ResolvedInterface->GetA(), 5);
+			}
+			TestFalse("TryGet<UObject>()", bool(DiContainer.Resolve().TryGet<UObject>(DI::EResolveErrorBehavior::ReturnNull)));
+		});
+		It("should bind UObjects polymorphically as their super classes and inherited interfaces", [this]
+		{
+			const TObjectPtr<UDerivedInterfaceImplementation> Service = NewObject<UDerivedInterfaceImplementation>();
+			Service->A = 5;
+			Service->B = 6;
+			TestTrue("BindResult", DiContainer.Bind().NamedPolymorphic<USimpleUService>(Service, "SomeName") == DI::EBindResult::Bound);
+
+			TestEqual("TryGetNamed<UDerivedInterfaceImplementation>()", DiContainer.Resolve().TryGetNamed<UDerivedInterfaceImplementation>("SomeName"), Service);
+			TObjectPtr<USimpleUService> ResolvedSuperClass = DiContainer.Resolve().TryGetNamed<USimpleUService>("SomeName");
+			if (TestTrue("TryGetNamed<USimpleUService>()", bool(ResolvedSuperClass)))
+			{
+				TestEqual("ResolvedSuperClass->A", ResolvedSuperClass->A, 5);
+			}
+			TScriptInterface<IDerivedSimpleInterface> ResolvedInterface = DiContainer.Resolve().TryGetNamed<IDerivedSimpleInterface>("SomeName");
+			if (TestTrue("TryGetNamed<IDerivedSimpleInterface>()", bool(ResolvedInterface)))
+			{
+				TestEqual("ResolvedInterface->GetB()", ResolvedInterface->GetB(), 6);
+			}
+			TScriptInterface<ISimpleInterface> ResolvedBaseInterface = DiContainer.Resolve().TryGetNamed<ISimpleInterface>("SomeName");
+			if (TestTrue("TryGetNamed<ISimpleInterface>()", bool(ResolvedBaseInterface)))
+			{
+				TestEqual("ResolvedBaseInterface->GetA()", ResolvedBaseInterface->GetA(), 5);
+			}
+			TestFalse("TryGet<ISimpleInterface>()", bool(DiContainer.Resolve().TryGet<ISimpleInterface>(DI::EResolveErrorBehavior::ReturnNull)));
+		});
+		It("should bind sibling UObjects polymorphically without binding their shared base class", [this]
+		{
+			const TObjectPtr<UDerivedInterfaceImplementation> Service = NewObject<UDerivedInterfaceImplementation>();
+			const TObjectPtr<USiblingUService> SiblingService = NewObject<USiblingUService>();
+			TestTrue("BindResult", DiContainer.Bind().Polymorphic<UDerivedInterfaceImplementation>(Service) == DI::EBindResult::Bound);
+			TestTrue("Sibling BindResult", DiContainer.Bind().Polymorphic<USiblingUService>(SiblingService) == DI::EBindResult::Bound);
+
+			TestEqual("TryGet<UDerivedInterfaceImplementation>()", DiContainer.Resolve().TryGet<UDerivedInterfaceImplementation>(), Service);
+			TestEqual("TryGet<USiblingUService>()", DiContainer.Resolve().TryGet<USiblingUService>(), SiblingService);
+			TestTrue("TryGet<IDerivedSimpleInterface>()", bool(DiContainer.Resolve().TryGet<IDerivedSimpleInterface>()));
+			TestFalse("TryGet<USimpleUService>()", bool(DiContainer.Resolve().TryGet<USimpleUService>(DI::EResolveErrorBehavior::ReturnNull)));
+		});
 		It("should bind ustructs", [this]
 		{
 			FSimpleUStructService Service = FSimpleUStructService{20};
@@ -58,6 +123,119 @@ void FDiContainerSpec::Define()
 				TestEqual("Resolved->A", Resolved->A, 20);
 			}
 		});
+		It("should bind ustructs that are too big to be stored inline", [this]
+		{
+			FLargeUStructService Service;
+			Service.Values = {1, 2, 3};
+			DiContainer.Bind().Instance<FLargeUStructService>(Service);
+			Service.Values.Reset();
+			TOptional<const FLargeUStructService&> Resolved = DiContainer.Resolve().TryGet<FLargeUStructService>();
+			if (TestTrue("Resolved.IsSet()", Resolved.IsSet()))
+			{
+				TestEqual("Resolved->Values.Num()", Resolved->Values.Num(), 3);
+			}
+		});
+		It("should resolve ustruct views without copying", [this]
+		{
+			FLargeUStructService Service;
+			Service.Values = {1, 2, 3};
+			DiContainer.Bind().Instance<FLargeUStructService>(Service);
+			DI::FUStructBindingView View = DiContainer.Resolve().TryGetUStructView(FLargeUStructService::StaticStruct());
+			TOptional<const FLargeUStructService&> Resolved = DiContainer.Resolve().TryGet<FLargeUStructService>();
+			if (TestTrue("View.IsValid()", View.IsValid()) && TestTrue("Resolved.IsSet()", Resolved.IsSet()))
+			{
+				TestEqual("View.GetMemory()", View.GetMemory(), reinterpret_cast<const uint8*>(&Resolved.GetValue()));
+				TestEqual("View.Get<FLargeUStructService>().Values.Num()", View.Get<FLargeUStructService>().Values.Num(), 3);
+			}
+		});
+		It("should construct lazy bindings once on first resolve", [this]
+		{
+			int32 NumConstructed = 0;
+			DiContainer.Bind().Lazy<FSimpleNativeService>([&NumConstructed]
+			{
+				++NumConstructed;
+				return MakeShared<FSimpleNativeService>(5);
+			});
+			TestEqual("NumConstructed after bind", NumConstructed, 0);
+
+			TSharedPtr<FSimpleNativeService> First = DiContainer.Resolve().TryGet<FSimpleNativeService>();
+			TSharedPtr<FSimpleNativeService> Second = DiContainer.Resolve().TryGet<FSimpleNativeService>();
+			TestEqual("NumConstructed after resolve", NumConstructed, 1);
+			TestTrue("Same instance", First.IsValid() && First == Second);
+		});
+		It("should let factories of lazy bindings resolve other lazy bindings", [this]
+		{
+			DiContainer.Bind().Lazy<FSimpleNativeService>([] { return MakeShared<FSimpleNativeService>(4); });
+			DiContainer.Bind().Lazy<FSimpleUStructService>([this]
+			{
+				return FSimpleUStructService(DiContainer.Resolve().TryGet<FSimpleNativeService>()->A + 1);
+			});
+
+			TOptional<const FSimpleUStructService&> Resolved = DiContainer.Resolve().TryGet<FSimpleUStructService>();
+			if (TestTrue("Resolved.IsSet()", Resolved.IsSet()))
+			{
+				TestEqual("Resolved->A", Resolved->A, 5);
+			}
+		});
+		It("should fulfill waiters of lazy bindings when they are constructed", [this]
+		{
+			bool bWasFulfilled = false;
+			DiContainer.Resolve().WaitFor<FSimpleUStructService>().Next([this, &bWasFulfilled](TOptional<const FSimpleUStructService&> Instance)
+			{
+				bWasFulfilled = TestTrue("Instance.IsSet()", Instance.IsSet()) && TestEqual("Instance->A", Instance->A, 3);
+			});
+			DiContainer.Bind().Lazy<FSimpleUStructService>([] { return FSimpleUStructService(3); });
+			TestTrue("bWasFulfilled", bWasFulfilled);
+		});
+		It("should reuse released instances of pools", [this]
+		{
+			DiContainer.Bind().Pooled<FSimpleNativeService>([] { return MakeShared<FSimpleNativeService>(); }, 1);
+			TSharedPtr<FSimpleNativeService> FirstInstance;
+			{
+				DI::TPooledInstance<FSimpleNativeService> First = DiContainer.Resolve().Acquire<FSimpleNativeService>();
+				DI::TPooledInstance<FSimpleNativeService> Second = DiContainer.Resolve().Acquire<FSimpleNativeService>();
+				TestTrue("Separate instances", First.IsValid() && Second.IsValid() && First.Get() != Second.Get());
+				FirstInstance = First.Get();
+				First.Release();
+			}
+			DI::TPooledInstance<FSimpleNativeService> Reused = DiContainer.Resolve().Acquire<FSimpleNativeService>();
+			TestTrue("Reused instance", Reused.IsValid() && Reused.Get() == FirstInstance.ToSharedRef());
+
+			TOptional<DI::FBindingPoolStats> Stats = DiContainer.Resolve().GetPoolStats<FSimpleNativeService>();
+			if (TestTrue("Stats.IsSet()", Stats.IsSet()))
+			{
+				TestEqual("NumCreated", Stats->NumCreated, 2);
+				TestEqual("NumAcquired", Stats->NumAcquired, 3);
+				TestEqual("NumDiscarded", Stats->NumDiscarded, 1);
+			}
+			TestFalse("Instance binding", DiContainer.Resolve().TryGet<FSimpleNativeService>(DI::EResolveErrorBehavior::ReturnNull).IsValid());
+		});
+		It("should remove bindings of destroyed UObjects after garbage collection", [this]
+		{
+			TObjectPtr<USimpleUService> Service = NewObject<USimpleUService>();
+			DiContainer.Bind().Instance<USimpleUService>(Service);
+			Service->MarkAsGarbage();
+			Service = nullptr;
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+			TestFalse("Found", DiContainer.FindBinding(DI::MakeBindingId<USimpleUService>()).IsValid());
+			TestTrue("Rebind", DiContainer.Bind().Instance<USimpleUService>(NewObject<USimpleUService>()) == DI::EBindResult::Bound);
+		});
+		It("should keep bound UObjects alive while the container is referenced", [this]
+		{
+			UDiContainerObject* ContainerObject = NewObject<UDiContainerObject>();
+			ContainerObject->AddToRoot();
+			TWeakObjectPtr<USimpleUService> WeakService = NewObject<USimpleUService>();
+			TWeakObjectPtr<USimpleInterfaceImplementation> WeakInterface = NewObject<USimpleInterfaceImplementation>();
+			ContainerObject->GetDiContainer().Bind().Instance<USimpleUService>(WeakService.Get());
+			ContainerObject->GetDiContainer().Bind().Instance<ISimpleInterface>(WeakInterface.Get());
+			ContainerObject->GetDiContainer().Bind().Instance<FSimpleNativeService>(MakeShared<FSimpleNativeService>());
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+			TestTrue("WeakService.IsValid()", WeakService.IsValid());
+			TestTrue("WeakInterface.IsValid()", WeakInterface.IsValid());
+			ContainerObject->RemoveFromRoot();
+		});
 	});
 
 	Describe("Resolve", [this]
@@ -273,6 +451,97 @@ void FDiContainerSpec::Define()
 				});
 			});
 
+			It("should cancel waits of destroyed waiting objects after garbage collection", [this]()
+			{
+				USimpleUService* WaitingObject = NewObject<USimpleUService>();
+				bool bWasCanceled = false;
+				DiContainer.Resolve().WaitFor<FSimpleNativeService>(WaitingObject, DI::EResolveErrorBehavior::ReturnNull).Next([&bWasCanceled](TOptional<TSharedRef<FSimpleNativeService>> Instance)
+				{
+					bWasCanceled = !Instance.IsSet();
+				});
+				WaitingObject->MarkAsGarbage();
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+				TestTrue("bWasCanceled", bWasCanceled);
+			});
+
+			It("should only notify subscribers that have not unsubscribed", [this]()
+			{
+				const DI::FBindingId BindingId = DI::MakeBindingId<USimpleUService>();
+				TArray<int32> NotifiedNumbers;
+				TArray<DI::FBindingSubscriptionHandle> Handles;
+				for (int32 Number = 0; Number < 300; ++Number)
+				{
+					Handles.Add(DiContainer.Subscribe(BindingId, [&NotifiedNumbers, Number](const DI::FBinding&) { NotifiedNumbers.Add(Number); }, nullptr));
+				}
+				for (int32 Number = 0; Number < Handles.Num(); Number += 2)
+				{
+					TestTrue("Unsubscribe", DiContainer.Unsubscribe(BindingId, Handles[Number]));
+				}
+				TestFalse("Unsubscribe twice", DiContainer.Unsubscribe(BindingId, Handles[0]));
+
+				DiContainer.Bind().Instance<USimpleUService>(NewObject<USimpleUService>());
+
+				if (TestEqual("NotifiedNumbers.Num()", NotifiedNumbers.Num(), 150))
+				{
+					TestEqual("NotifiedNumbers[0]", NotifiedNumbers[0], 1);
+				}
+				TestFalse("Unsubscribe after notification", DiContainer.Unsubscribe(BindingId, Handles[1]));
+			});
+
+			It("should reuse the waiters of unsubscribed subscriptions while others keep waiting", [this]()
+			{
+				const DI::FBindingId BindingId = DI::MakeBindingId<USimpleUService>();
+				int32 NumNotified = 0;
+				const DI::FBindingSubscriptionHandle RemainingHandle = DiContainer.Subscribe(BindingId, [&NumNotified](const DI::FBinding&) { ++NumNotified; }, nullptr);
+				DI::FBindingSubscriptionHandle Handle;
+				for (int32 Number = 0; Number < 1000; ++Number)
+				{
+					Handle = DiContainer.Subscribe(BindingId, [&NumNotified](const DI::FBinding&) { ++NumNotified; }, nullptr);
+					if (!TestTrue("Unsubscribe", DiContainer.Unsubscribe(BindingId, Handle)))
+						return;
+				}
+				TestNotEqual("Reused waiter is not the remaining one", Handle.WaiterIndex, RemainingHandle.WaiterIndex);
+				TestTrue("Reused the waiter of the first unsubscribed subscription", Handle.WaiterIndex <= 1);
+
+				DiContainer.Bind().Instance<USimpleUService>(NewObject<USimpleUService>());
+				TestEqual("NumNotified", NumNotified, 1);
+			});
+
+			It("should notify set subscribers with the whole set", [this]()
+			{
+				DiContainer.Bind().AddToSet<USimpleUService>(NewObject<USimpleUService>());
+				int32 NumNotifiedElements = 0;
+				DiContainer.Subscribe(DI::MakeSetBindingId<USimpleUService>(), [&NumNotifiedElements](const DI::FBinding& Binding)
+				{
+					NumNotifiedElements = static_cast<const DI::FBindingSet&>(Binding).Num();
+				}, nullptr);
+				DiContainer.Bind().AddToSet<USimpleUService>(NewObject<USimpleUService>());
+
+				TestEqual("NumNotifiedElements", NumNotifiedElements, 2);
+			});
+
+			It("should notify deferred subscribers once when notifications are flushed", [this]()
+			{
+				DiContainer.SetNotificationMode(DI::EBindingNotificationMode::Deferred);
+				TArray<TSharedPtr<FSimpleNativeService>> Notified;
+				DiContainer.Resolve().WaitFor<FSimpleNativeService>().Next([&Notified](TOptional<TSharedRef<FSimpleNativeService>> Instance)
+				{
+					Notified.Add(Instance.IsSet() ? Instance->ToSharedPtr() : nullptr);
+				});
+				TSharedRef<FSimpleNativeService> Service = MakeShared<FSimpleNativeService>();
+				DiContainer.Bind().Instance<FSimpleNativeService>(Service);
+				TestEqual("Notified.Num() before flush", Notified.Num(), 0);
+
+				DiContainer.FlushNotifications();
+				if (TestEqual("Notified.Num() after flush", Notified.Num(), 1))
+				{
+					TestTrue("Notified[0]", Notified[0] == Service);
+				}
+				DiContainer.FlushNotifications();
+				TestEqual("Notified.Num() after second flush", Notified.Num(), 1);
+			});
+
 			It("WaitFor should resolve structs via a reference to the binding storage", [this]()
 			{
 				DiContainer.Resolve().WaitFor<FSimpleUStructService>().Next([&, this](TOptional<const FSimpleUStructService&> Instance)
@@ -8,6 +8,16 @@ int32 USimpleInterfaceImplementation::GetA() const
 	return A;
 }
 
+int32 UDerivedInterfaceImplementation::GetA() const
+{
+	return A;
+}
+
+int32 UDerivedInterfaceImplementation::GetB() const
+{
+	return B;
+}
+
 namespace DI
 {
 	namespace InjectTest
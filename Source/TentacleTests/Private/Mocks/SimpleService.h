@@ -38,6 +38,31 @@ struct FSimpleUStructService
 	}
 };
 
+/** Too big to be stored inline in a binding and not plain old data. */
+USTRUCT()
+struct FLargeUStructService
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<int32> Values;
+
+	int32 Padding[32] = {};
+};
+
+/** Has reflected members of different types, so single members can be resolved by name. */
+USTRUCT()
+struct FMemberUStructService
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Number = 0;
+
+	UPROPERTY()
+	FString Text;
+};
+
 class FSimpleNativeService
 {
 public:
@@ -83,6 +108,42 @@ public:
 	int32 A;
 };
 
+UINTERFACE(NotBlueprintable, NotBlueprintType)
+class UDerivedSimpleInterface : public USimpleInterface
+{
+	GENERATED_BODY()
+};
+
+class IDerivedSimpleInterface : public ISimpleInterface
+{
+	GENERATED_BODY()
+
+public:
+	virtual int32 GetB() const = 0;
+};
+
+/** Implements ISimpleInterface only through IDerivedSimpleInterface. */
+UCLASS()
+class UDerivedInterfaceImplementation : public USimpleUService, public IDerivedSimpleInterface
+{
+	GENERATED_BODY()
+
+public:
+	//  - IDerivedSimpleInterface
+	virtual int32 GetA() const override;
+	virtual int32 GetB() const override;
+	// -- 
+
+	int32 B;
+};
+
+/** Shares USimpleUService as its base with UDerivedInterfaceImplementation. */
+UCLASS()
+class USiblingUService : public USimpleUService
+{
+	GENERATED_BODY()
+};
+
 namespace DI
 {
 	namespace InjectTest